@@ -0,0 +1,92 @@
+/*
+ * File: bench_perf.c
+ * Author: 0xNullll
+ * Description: perf_event_open counters for the benchmark.
+ * License: MIT
+ */
+
+#include "bench_perf.h"
+
+#if defined(__linux__)
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <string.h>
+#include <unistd.h>
+
+static int bench_perf_event(uint32_t type, uint64_t config) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+bool bench_perf_open(bench_perf_t *p) {
+    p->fd[BENCH_PERF_CYCLES] = bench_perf_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    p->fd[BENCH_PERF_INSTRUCTIONS] = bench_perf_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    p->fd[BENCH_PERF_BRANCH_MISSES] = bench_perf_event(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    p->fd[BENCH_PERF_L1D_MISSES] = bench_perf_event(PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+
+    bool any = false;
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        p->value[i] = 0;
+        if (p->fd[i] >= 0) any = true;
+    }
+    return any;
+}
+
+void bench_perf_close(bench_perf_t *p) {
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        if (p->fd[i] >= 0) close(p->fd[i]);
+        p->fd[i] = -1;
+    }
+}
+
+void bench_perf_start(bench_perf_t *p) {
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        if (p->fd[i] < 0) continue;
+        ioctl(p->fd[i], PERF_EVENT_IOC_RESET, 0);
+        ioctl(p->fd[i], PERF_EVENT_IOC_ENABLE, 0);
+    }
+}
+
+void bench_perf_stop(bench_perf_t *p) {
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        if (p->fd[i] >= 0) ioctl(p->fd[i], PERF_EVENT_IOC_DISABLE, 0);
+    }
+
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        uint64_t buf[3]; // value, time enabled, time running
+        p->value[i] = 0;
+        if (p->fd[i] < 0 || read(p->fd[i], buf, sizeof(buf)) != (ssize_t)sizeof(buf)) continue;
+
+        // More events than PMU slots: the kernel time-slices them, scale back up
+        if (buf[2] && buf[2] < buf[1]) buf[0] = (uint64_t)((double)buf[0] * (double)buf[1] / (double)buf[2]);
+        p->value[i] = buf[0];
+    }
+}
+
+#else // !__linux__
+
+bool bench_perf_open(bench_perf_t *p) {
+    for (int i = 0; i < BENCH_PERF_COUNT; i++) {
+        p->fd[i] = -1;
+        p->value[i] = 0;
+    }
+    return false;
+}
+
+void bench_perf_close(bench_perf_t *p) { (void)p; }
+void bench_perf_start(bench_perf_t *p) { (void)p; }
+void bench_perf_stop(bench_perf_t *p) { (void)p; }
+
+#endif // __linux__
@@ -0,0 +1,42 @@
+/*
+ * File: bench_perf.h
+ * Author: 0xNullll
+ * Description: Hardware performance counters for the benchmark (Linux
+ *              perf_event_open): cycles, instructions, branch misses and
+ *              L1D read misses, user space only. Counters that cannot be
+ *              opened (other OS, VM without a PMU, perf_event_paranoid)
+ *              are reported as unavailable and the benchmark runs without.
+ * License: MIT
+ */
+
+#ifndef BENCH_PERF_H
+#define BENCH_PERF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    BENCH_PERF_CYCLES = 0,
+    BENCH_PERF_INSTRUCTIONS,
+    BENCH_PERF_BRANCH_MISSES,
+    BENCH_PERF_L1D_MISSES,
+    BENCH_PERF_COUNT
+} bench_perf_counter_t;
+
+typedef struct {
+    int fd[BENCH_PERF_COUNT];       // -1 when the counter could not be opened
+    uint64_t value[BENCH_PERF_COUNT]; // last measurement, scaled for multiplexing
+} bench_perf_t;
+
+// Opens whatever counters the system allows; returns false if none could be opened
+bool bench_perf_open(bench_perf_t *p);
+void bench_perf_close(bench_perf_t *p);
+
+void bench_perf_start(bench_perf_t *p);
+void bench_perf_stop(bench_perf_t *p);
+
+static inline bool bench_perf_has(const bench_perf_t *p, bench_perf_counter_t c) {
+    return p->fd[c] >= 0;
+}
+
+#endif // BENCH_PERF_H
@@ -0,0 +1,676 @@
+/*
+ * File: cbase_bench.c
+ * Author: 0xNullll
+ * Description: Throughput benchmark for Tiny CBase. Every codec runs over the
+ *              same size sweep; Base64 is also compared against whatever
+ *              other implementations were found at configure time (OpenSSL,
+ *              libresolv b64_ntop/b64_pton) and a vendored reference scalar
+ *              codec. Missing implementations are skipped.
+ *              Results are GB/s of raw (unencoded) data for both directions,
+ *              plus IPC and branch / L1D misses per byte when the hardware
+ *              counters can be read (see bench_perf.h).
+ *              --trace replays a size/mode trace and reports per-call
+ *              latency percentiles instead; --neighbour measures how much
+ *              of a co-located working set a large encode/decode evicts,
+ *              with regular and with streaming stores.
+ * License: MIT
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include "tiny_cbase.h"
+#include "ref_base64.h"
+#include "bench_perf.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if BENCH_HAVE_OPENSSL
+#include <openssl/evp.h>
+#endif
+
+#if BENCH_HAVE_RESOLV
+#include <sys/types.h>
+#include <netinet/in.h>
+#include <arpa/nameser.h>
+#include <resolv.h>
+#endif
+
+#define BENCH_MAX_SIZE     (16u << 20)
+#define BENCH_BASE58_MAX   1024u // Base58 is quadratic, larger sizes take minutes
+#define BENCH_MIN_TIME_SEC 0.1
+
+static const size_t BENCH_SIZES[] = {16, 64, 256, 1024, 4096, 65536, 1u << 20, BENCH_MAX_SIZE};
+
+// A benchmarked call: in -> out, returns false on failure
+typedef bool (*bench_fn)(const void *in, size_t in_len, void *out, size_t *out_len);
+
+typedef struct {
+    const char *codec;
+    const char *impl;
+    const char *op;
+    bench_fn run;
+    bench_fn prep;      // encoder producing the input of a decode case, NULL for encoders
+    size_t max_size;    // 0 = whole sweep
+} bench_case_t;
+
+static double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+//
+// --- Tiny CBase ---
+//
+
+static bool tiny_b16_enc(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE16_Encode((const uint8_t *)in, n, (char *)out, out_len, BASE16_UPPER);
+}
+static bool tiny_b16_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE16_Decode((const char *)in, n, (uint8_t *)out, out_len);
+}
+static bool tiny_b32_enc(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE32_EncodeStd((const uint8_t *)in, n, (char *)out, out_len);
+}
+static bool tiny_b32_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE32_DecodeStd((const char *)in, n, (uint8_t *)out, out_len);
+}
+static bool tiny_b58_enc(const void *in, size_t n, void *out, size_t *out_len) {
+    *out_len = BASE58_ENC_LEN(n) + 1; // BASE58_Encode takes the buffer size in *out_len
+    return BASE58_Encode((const uint8_t *)in, n, (char *)out, out_len);
+}
+static bool tiny_b58_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE58_Decode((const char *)in, n, (uint8_t *)out, out_len);
+}
+static bool tiny_b64_enc(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE64_EncodeStd((const uint8_t *)in, n, (char *)out, out_len);
+}
+static bool tiny_b64_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE64_DecodeStd((const char *)in, n, (uint8_t *)out, out_len);
+}
+static bool tiny_b64_ct_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE64_DecodeStdCT((const char *)in, n, (uint8_t *)out, out_len);
+}
+static bool tiny_b64_par_enc(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE_EncodeParallel((const uint8_t *)in, n, (char *)out, out_len, BASE64_STD_ENC, 0);
+}
+static bool tiny_b64_par_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE_DecodeParallel((const char *)in, n, (uint8_t *)out, out_len, BASE64_STD_DEC, 0, NULL);
+}
+static bool tiny_b85_enc(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE85_EncodeStd((const uint8_t *)in, n, (char *)out, out_len);
+}
+static bool tiny_b85_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE85_DecodeStd((const char *)in, n, (uint8_t *)out, out_len);
+}
+static bool tiny_z85_enc(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE85_EncodeZ85((const uint8_t *)in, n, (char *)out, out_len);
+}
+static bool tiny_z85_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    return BASE85_DecodeZ85((const char *)in, n, (uint8_t *)out, out_len);
+}
+
+//
+// --- Other Base64 implementations ---
+//
+
+static bool ref_b64_enc(const void *in, size_t n, void *out, size_t *out_len) {
+    *out_len = REF_Base64Encode((const uint8_t *)in, n, (char *)out);
+    return true;
+}
+static bool ref_b64_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    return REF_Base64Decode((const char *)in, n, (uint8_t *)out, out_len);
+}
+
+#if BENCH_HAVE_OPENSSL
+static bool ossl_b64_enc(const void *in, size_t n, void *out, size_t *out_len) {
+    *out_len = (size_t)EVP_EncodeBlock((unsigned char *)out, (const unsigned char *)in, (int)n);
+    return true;
+}
+static bool ossl_b64_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    int r = EVP_DecodeBlock((unsigned char *)out, (const unsigned char *)in, (int)n);
+    if (r < 0) return false;
+    *out_len = (size_t)r;
+    return true;
+}
+#endif
+
+#if BENCH_HAVE_RESOLV
+static bool resolv_b64_enc(const void *in, size_t n, void *out, size_t *out_len) {
+    int r = b64_ntop((const unsigned char *)in, n, (char *)out, BASE64_ENC_LEN(n));
+    if (r < 0) return false;
+    *out_len = (size_t)r;
+    return true;
+}
+static bool resolv_b64_dec(const void *in, size_t n, void *out, size_t *out_len) {
+    // b64_pton reads a NUL-terminated string; the prepared input is one
+    int r = b64_pton((const char *)in, (unsigned char *)out, BASE64_DEC_LEN(n));
+    if (r < 0) return false;
+    *out_len = (size_t)r;
+    return true;
+}
+#endif
+
+static const bench_case_t BENCH_CASES[] = {
+    {"base16", "tiny_cbase", "enc", tiny_b16_enc, NULL, 0},
+    {"base16", "tiny_cbase", "dec", tiny_b16_dec, tiny_b16_enc, 0},
+    {"base32", "tiny_cbase", "enc", tiny_b32_enc, NULL, 0},
+    {"base32", "tiny_cbase", "dec", tiny_b32_dec, tiny_b32_enc, 0},
+    {"base58", "tiny_cbase", "enc", tiny_b58_enc, NULL, BENCH_BASE58_MAX},
+    {"base58", "tiny_cbase", "dec", tiny_b58_dec, tiny_b58_enc, BENCH_BASE58_MAX},
+    {"base64", "tiny_cbase", "enc", tiny_b64_enc, NULL, 0},
+    {"base64", "tiny_cbase", "dec", tiny_b64_dec, tiny_b64_enc, 0},
+    {"base64", "tiny_ct", "dec", tiny_b64_ct_dec, tiny_b64_enc, 0},
+    {"base64", "tiny_par", "enc", tiny_b64_par_enc, NULL, 0},
+    {"base64", "tiny_par", "dec", tiny_b64_par_dec, tiny_b64_enc, 0},
+    {"base64", "reference", "enc", ref_b64_enc, NULL, 0},
+    {"base64", "reference", "dec", ref_b64_dec, tiny_b64_enc, 0},
+#if BENCH_HAVE_OPENSSL
+    {"base64", "openssl", "enc", ossl_b64_enc, NULL, 0},
+    {"base64", "openssl", "dec", ossl_b64_dec, tiny_b64_enc, 0},
+#endif
+#if BENCH_HAVE_RESOLV
+    {"base64", "libresolv", "enc", resolv_b64_enc, NULL, 0},
+    {"base64", "libresolv", "dec", resolv_b64_dec, tiny_b64_enc, 0},
+#endif
+    {"ascii85", "tiny_cbase", "enc", tiny_b85_enc, NULL, 0},
+    {"ascii85", "tiny_cbase", "dec", tiny_b85_dec, tiny_b85_enc, 0},
+    {"z85", "tiny_cbase", "enc", tiny_z85_enc, NULL, 0},
+    {"z85", "tiny_cbase", "dec", tiny_z85_dec, tiny_z85_enc, 0},
+};
+
+static bench_perf_t bench_perf;
+static bool bench_perf_on = false;
+
+// Runs c on in until BENCH_MIN_TIME_SEC has passed, returns seconds per call.
+// *out_iters is the call count of the timed run the counters cover.
+static double bench_measure(const bench_case_t *c, const void *in, size_t in_len, void *out, size_t *out_iters) {
+    size_t out_len;
+    size_t iters = 1;
+
+    for (;;) {
+        if (bench_perf_on) bench_perf_start(&bench_perf);
+        double t0 = bench_now();
+        for (size_t k = 0; k < iters; k++) {
+            if (!c->run(in, in_len, out, &out_len)) return -1.0;
+        }
+        double dt = bench_now() - t0;
+        if (bench_perf_on) bench_perf_stop(&bench_perf);
+
+        if (dt >= BENCH_MIN_TIME_SEC) {
+            *out_iters = iters;
+            return dt / (double)iters;
+        }
+        iters *= (dt > 0.0 && dt < BENCH_MIN_TIME_SEC / 8) ? 8 : 2;
+    }
+}
+
+// IPC and misses per raw byte of the last measurement, "-" when not counted
+static void bench_print_counters(size_t bytes) {
+    const uint64_t *v = bench_perf.value;
+
+    if (bench_perf_on && bench_perf_has(&bench_perf, BENCH_PERF_CYCLES) &&
+        bench_perf_has(&bench_perf, BENCH_PERF_INSTRUCTIONS) && v[BENCH_PERF_CYCLES]) {
+        printf(" %6.2f", (double)v[BENCH_PERF_INSTRUCTIONS] / (double)v[BENCH_PERF_CYCLES]);
+    } else {
+        printf(" %6s", "-");
+    }
+
+    if (bench_perf_on && bench_perf_has(&bench_perf, BENCH_PERF_BRANCH_MISSES)) {
+        printf(" %10.5f", (double)v[BENCH_PERF_BRANCH_MISSES] / (double)bytes);
+    } else {
+        printf(" %10s", "-");
+    }
+
+    if (bench_perf_on && bench_perf_has(&bench_perf, BENCH_PERF_L1D_MISSES)) {
+        printf(" %10.5f", (double)v[BENCH_PERF_L1D_MISSES] / (double)bytes);
+    } else {
+        printf(" %10s", "-");
+    }
+}
+
+static void bench_print_size(size_t n) {
+    if (n >= (1u << 20)) printf("%6zuM", n >> 20);
+    else if (n >= 1024) printf("%6zuK", n >> 10);
+    else printf("%7zu", n);
+}
+
+//
+// --- Trace replay ---
+//
+// A trace is one call per line: "<size> <codec>/<op>" or "<size> <codec>/<impl>/<op>"
+// (impl defaults to tiny_cbase); '#' starts a comment. Each call is timed on
+// its own, and latencies are reported per case and size class.
+
+#define BENCH_REPLAY_CLASSES 3
+
+static const size_t BENCH_REPLAY_CLASS_MAX[BENCH_REPLAY_CLASSES] = {256, 65536, BENCH_MAX_SIZE};
+static const char *BENCH_REPLAY_CLASS_NAME[BENCH_REPLAY_CLASSES] = {"<=256B", "<=64K", "large"};
+
+typedef struct {
+    size_t size;
+    size_t case_index;
+} bench_call_t;
+
+static uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int bench_cmp_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static bool bench_find_case(const char *mode, size_t *out_index) {
+    char codec[32], impl[32], op[8];
+
+    if (sscanf(mode, "%31[^/]/%31[^/]/%7s", codec, impl, op) != 3) {
+        if (sscanf(mode, "%31[^/]/%7s", codec, op) != 2) return false;
+        strcpy(impl, "tiny_cbase");
+    }
+
+    for (size_t i = 0; i < sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]); i++) {
+        const bench_case_t *c = &BENCH_CASES[i];
+        if (!strcmp(c->codec, codec) && !strcmp(c->impl, impl) && !strcmp(c->op, op)) {
+            *out_index = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool bench_load_trace(const char *path, bench_call_t **out_calls, size_t *out_count) {
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "Error: cannot open trace %s\n", path);
+        return false;
+    }
+
+    bench_call_t *calls = NULL;
+    size_t count = 0, cap = 0;
+    char line[256];
+    size_t line_no = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        line_no++;
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        size_t size;
+        char mode[80];
+        int fields = sscanf(line, "%zu %79s", &size, mode);
+        if (fields <= 0) continue; // blank or comment
+
+        bench_call_t call = {size, 0};
+        if (fields != 2 || size == 0 || size > BENCH_MAX_SIZE || !bench_find_case(mode, &call.case_index)) {
+            fprintf(stderr, "Error: %s:%zu: bad or unsupported entry\n", path, line_no);
+            fclose(f);
+            free(calls);
+            return false;
+        }
+
+        if (count == cap) {
+            cap = cap ? cap * 2 : 256;
+            bench_call_t *grown = realloc(calls, cap * sizeof(*calls));
+            if (!grown) {
+                fclose(f);
+                free(calls);
+                return false;
+            }
+            calls = grown;
+        }
+        calls[count++] = call;
+    }
+
+    fclose(f);
+    *out_calls = calls;
+    *out_count = count;
+    return count != 0;
+}
+
+static size_t bench_size_class(size_t size) {
+    size_t k = 0;
+    while (size > BENCH_REPLAY_CLASS_MAX[k]) k++;
+    return k;
+}
+
+static int bench_replay(const char *path, size_t repeat, const uint8_t *raw, char *enc, uint8_t *out) {
+    bench_call_t *calls;
+    size_t count;
+    if (!bench_load_trace(path, &calls, &count)) return 1;
+
+    // One latency per call, grouped by (case, size class)
+    const size_t ncases = sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]);
+    const size_t ngroups = ncases * BENCH_REPLAY_CLASSES;
+    size_t *group_len = NULL, *group_of = NULL, *group_pos = NULL, *group_fill = NULL;
+    uint64_t *lat = NULL;
+    int rc = 1;
+
+    if (repeat && count > SIZE_MAX / sizeof(uint64_t) / repeat) {
+        fprintf(stderr, "Error: %s: %zu calls x %zu repeats is too many\n", path, count, repeat);
+        goto done;
+    }
+    group_len = calloc(ngroups, sizeof(size_t));
+    lat = malloc(count * repeat * sizeof(uint64_t));
+    group_of = malloc(count * sizeof(size_t));
+    // Latencies are laid out group after group so each one can be sorted in place
+    group_pos = malloc(ngroups * sizeof(size_t));
+    group_fill = calloc(ngroups, sizeof(size_t));
+    if (!group_len || !lat || !group_of || !group_pos || !group_fill) {
+        fprintf(stderr, "Error: out of memory\n");
+        goto done;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        group_of[i] = calls[i].case_index * BENCH_REPLAY_CLASSES + bench_size_class(calls[i].size);
+        group_len[group_of[i]] += repeat;
+    }
+    for (size_t g = 0, pos = 0; g < ngroups; g++) {
+        group_pos[g] = pos;
+        pos += group_len[g];
+    }
+
+    for (size_t r = 0; r < repeat; r++) {
+        for (size_t i = 0; i < count; i++) {
+            const bench_case_t *c = &BENCH_CASES[calls[i].case_index];
+            const void *in = raw;
+            size_t in_len = calls[i].size;
+            size_t out_len;
+
+            if (c->prep) {
+                if (!c->prep(raw, calls[i].size, enc, &in_len)) {
+                    fprintf(stderr, "Error: %s/%s/%s: preparing input failed on %zu bytes\n", c->codec, c->impl, c->op, calls[i].size);
+                    goto done;
+                }
+                enc[in_len] = '\0';
+                in = enc;
+            }
+
+            uint64_t t0 = bench_now_ns();
+            bool ok = c->run(in, in_len, out, &out_len);
+            uint64_t dt = bench_now_ns() - t0;
+
+            if (!ok) {
+                fprintf(stderr, "Error: %s/%s/%s failed on %zu bytes\n", c->codec, c->impl, c->op, calls[i].size);
+                goto done;
+            }
+            size_t g = group_of[i];
+            lat[group_pos[g] + group_fill[g]++] = dt;
+        }
+    }
+
+    printf("# %s: %zu calls x %zu\n", path, count, repeat);
+    printf("%-8s %-11s %-3s %-7s %8s %10s %10s %10s\n", "codec", "impl", "op", "sizes", "calls", "p50 ns", "p99 ns", "p99.9 ns");
+
+    for (size_t g = 0; g < ngroups; g++) {
+        size_t n = group_len[g];
+        if (!n) continue;
+
+        uint64_t *v = lat + group_pos[g];
+        qsort(v, n, sizeof(uint64_t), bench_cmp_u64);
+
+        const bench_case_t *c = &BENCH_CASES[g / BENCH_REPLAY_CLASSES];
+        printf("%-8s %-11s %-3s %-7s %8zu %10llu %10llu %10llu\n", c->codec, c->impl, c->op,
+               BENCH_REPLAY_CLASS_NAME[g % BENCH_REPLAY_CLASSES], n,
+               (unsigned long long)v[n / 2], (unsigned long long)v[n * 99 / 100], (unsigned long long)v[n * 999 / 1000]);
+    }
+    rc = 0;
+
+done:
+    free(calls);
+    free(group_len);
+    free(group_pos);
+    free(group_fill);
+    free(group_of);
+    free(lat);
+    return rc;
+}
+
+//
+// --- Neighbour effect ---
+//
+// A neighbour keeps a working set hot in the cache, the codec then writes a
+// large output, and the neighbour's next pass over its working set shows how
+// much of it was evicted. Run with regular stores (streaming off) and with
+// streaming stores (threshold 0), plus an idle baseline.
+
+#define BENCH_NEIGHBOUR_WSS    (1u << 20)  // neighbour working set
+#define BENCH_NEIGHBOUR_SIZE   (64u << 20) // raw bytes per codec call between passes
+#define BENCH_NEIGHBOUR_ROUNDS 9
+#define BENCH_LINE             64
+
+// One random cycle over all cache lines of the working set (first word of each
+// line holds the next line), so the prefetchers cannot hide the misses
+static size_t *bench_chase_build(size_t lines) {
+    size_t stride = BENCH_LINE / sizeof(size_t);
+    size_t *next = calloc(lines * stride, sizeof(size_t));
+    size_t *order = malloc(lines * sizeof(size_t));
+    if (!next || !order) {
+        free(next);
+        free(order);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < lines; i++) order[i] = i;
+    for (size_t i = lines - 1; i > 0; i--) {
+        size_t j = (size_t)rand() % (i + 1);
+        size_t t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+    for (size_t i = 0; i < lines; i++) next[order[i] * stride] = order[(i + 1) % lines];
+
+    free(order);
+    return next;
+}
+
+// One pass over the working set, ns per line
+static double bench_chase(const size_t *next, size_t lines) {
+    size_t stride = BENCH_LINE / sizeof(size_t);
+    volatile size_t sink;
+    size_t p = 0;
+
+    uint64_t t0 = bench_now_ns();
+    for (size_t i = 0; i < lines; i++) p = next[p * stride];
+    uint64_t dt = bench_now_ns() - t0;
+
+    sink = p;
+    (void)sink;
+    return (double)dt / (double)lines;
+}
+
+static double bench_median(double *v, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        for (size_t j = i; j > 0 && v[j - 1] > v[j]; j--) {
+            double t = v[j];
+            v[j] = v[j - 1];
+            v[j - 1] = t;
+        }
+    }
+    return v[n / 2];
+}
+
+static int bench_neighbour(void) {
+    size_t lines = BENCH_NEIGHBOUR_WSS / BENCH_LINE;
+    size_t enc_cap = BASE64_ENC_LEN(BENCH_NEIGHBOUR_SIZE);
+    size_t *next = bench_chase_build(lines);
+    uint8_t *raw = malloc(BENCH_NEIGHBOUR_SIZE);
+    char *enc = malloc(enc_cap);
+    uint8_t *dec = malloc(BASE64_DEC_LEN(enc_cap));
+    if (!next || !raw || !enc || !dec) {
+        fprintf(stderr, "Error: out of memory\n");
+        free(next);
+        free(raw);
+        free(enc);
+        free(dec);
+        return 1;
+    }
+
+    size_t saved = BASE_GetStreamThreshold();
+    size_t enc_len = 0, dec_len = 0;
+    for (size_t i = 0; i < BENCH_NEIGHBOUR_SIZE; i++) raw[i] = (uint8_t)rand();
+    BASE64_Encode(raw, BENCH_NEIGHBOUR_SIZE, enc, &enc_len, BASE64_STD_ENC); // decode input, also faults the pages in
+    BASE64_Decode(enc, enc_len, dec, &dec_len, BASE64_STD_DEC);
+
+    printf("# neighbour: %u KiB working set, base64 of %u MiB between passes, median of %d\n",
+           BENCH_NEIGHBOUR_WSS >> 10, BENCH_NEIGHBOUR_SIZE >> 20, BENCH_NEIGHBOUR_ROUNDS);
+    printf("%-4s %-10s %18s %9s\n", "op", "stores", "neighbour ns/line", "GB/s");
+
+    // op 0: idle, 1: encode, 2: decode; each with streaming off (SIZE_MAX) and on (0)
+    for (int op = 0; op < 3; op++) {
+        for (int streaming = 0; streaming < 2; streaming++) {
+            if (op == 0 && streaming) continue;
+            BASE_SetStreamThreshold(streaming ? 0 : SIZE_MAX);
+
+            double ns[BENCH_NEIGHBOUR_ROUNDS];
+            double sec = 0.0;
+            for (int r = 0; r < BENCH_NEIGHBOUR_ROUNDS; r++) {
+                bench_chase(next, lines); // warm the working set
+                double t0 = bench_now();
+                bool ok = true;
+                if (op == 1) ok = BASE64_Encode(raw, BENCH_NEIGHBOUR_SIZE, enc, &enc_len, BASE64_STD_ENC);
+                if (op == 2) ok = BASE64_Decode(enc, enc_len, dec, &dec_len, BASE64_STD_DEC);
+                sec += bench_now() - t0;
+                if (!ok) {
+                    fprintf(stderr, "Error: neighbour: codec call failed\n");
+                    BASE_SetStreamThreshold(saved);
+                    free(next);
+                    free(raw);
+                    free(enc);
+                    free(dec);
+                    return 1;
+                }
+                ns[r] = bench_chase(next, lines);
+            }
+
+            printf("%-4s %-10s %18.2f", op == 0 ? "-" : (op == 1 ? "enc" : "dec"),
+                   op == 0 ? "idle" : (streaming ? "streaming" : "regular"), bench_median(ns, BENCH_NEIGHBOUR_ROUNDS));
+            if (op == 0) printf(" %9s\n", "-");
+            else printf(" %9.3f\n", (double)BENCH_NEIGHBOUR_SIZE * BENCH_NEIGHBOUR_ROUNDS / sec / 1e9);
+        }
+    }
+
+    BASE_SetStreamThreshold(saved);
+    free(next);
+    free(raw);
+    free(enc);
+    free(dec);
+    return 0;
+}
+
+// --hugepages: the sweep buffers come from BASE_AllocBuffer (THP-backed on Linux)
+static bool bench_hugepages = false;
+
+static void *bench_alloc(size_t size) {
+    return bench_hugepages ? BASE_AllocBuffer(size) : malloc(size);
+}
+
+static void bench_free(void *buf, size_t size) {
+    if (bench_hugepages) BASE_FreeBuffer(buf, size);
+    else free(buf);
+}
+
+int main(int argc, char *argv[]) {
+    const char *filter = NULL; // substring of "codec/impl/op"
+    const char *trace = NULL;
+    size_t repeat = 10;
+    bool use_perf = true;
+    bool neighbour = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--no-perf") == 0) use_perf = false;
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) trace = argv[++i];
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) repeat = (size_t)strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--neighbour") == 0) neighbour = true;
+        else if (strcmp(argv[i], "--hugepages") == 0) bench_hugepages = true;
+        else filter = argv[i];
+    }
+    if (repeat == 0) repeat = 1;
+
+    if (neighbour) {
+        srand(1);
+        return bench_neighbour();
+    }
+
+    size_t buf_len = BASE_GetEncodeLen(BENCH_MAX_SIZE, BASE16_UPPER); // largest expansion
+    uint8_t *raw = bench_alloc(BENCH_MAX_SIZE);
+    char *enc = bench_alloc(buf_len);
+    uint8_t *out = bench_alloc(buf_len);
+    if (!raw || !enc || !out) {
+        fprintf(stderr, "Error: out of memory\n");
+        return 1;
+    }
+    if (bench_hugepages) printf("# buffers: BASE_AllocBuffer (MADV_HUGEPAGE)\n");
+
+    srand(1);
+    for (size_t i = 0; i < BENCH_MAX_SIZE; i++) raw[i] = (uint8_t)rand();
+
+    if (trace) {
+        int rc = bench_replay(trace, repeat, raw, enc, out);
+        bench_free(raw, BENCH_MAX_SIZE);
+        bench_free(enc, buf_len);
+        bench_free(out, buf_len);
+        return rc;
+    }
+
+#if !BENCH_HAVE_OPENSSL
+    printf("# openssl: not found, skipped\n");
+#endif
+#if !BENCH_HAVE_RESOLV
+    printf("# libresolv b64_ntop/b64_pton: not found, skipped\n");
+#endif
+    if (use_perf) {
+        bench_perf_on = bench_perf_open(&bench_perf);
+        if (!bench_perf_on) printf("# perf counters: unavailable (no PMU access or perf_event_paranoid), skipped\n");
+    }
+
+    printf("%-8s %-11s %-3s %7s %9s %6s %10s %10s\n", "codec", "impl", "op", "size", "GB/s", "IPC", "brmiss/B", "L1Dmiss/B");
+
+    for (size_t ci = 0; ci < sizeof(BENCH_CASES) / sizeof(BENCH_CASES[0]); ci++) {
+        const bench_case_t *c = &BENCH_CASES[ci];
+        char name[64];
+        snprintf(name, sizeof(name), "%s/%s/%s", c->codec, c->impl, c->op);
+        if (filter && !strstr(name, filter)) continue;
+
+        for (size_t si = 0; si < sizeof(BENCH_SIZES) / sizeof(BENCH_SIZES[0]); si++) {
+            size_t n = BENCH_SIZES[si];
+            if (c->max_size && n > c->max_size) break;
+
+            const void *in = raw;
+            size_t in_len = n;
+            if (c->prep) {
+                if (!c->prep(raw, n, enc, &in_len)) {
+                    fprintf(stderr, "Error: %s: preparing input failed\n", name);
+                    return 1;
+                }
+                enc[in_len] = '\0';
+                in = enc;
+            }
+
+            size_t iters = 0;
+            double sec = bench_measure(c, in, in_len, out, &iters);
+            printf("%-8s %-11s %-3s ", c->codec, c->impl, c->op);
+            bench_print_size(n);
+            if (sec < 0) {
+                printf(" %9s\n", "failed");
+                continue;
+            }
+            printf(" %9.3f", (double)n / sec / 1e9);
+            bench_print_counters(n * iters);
+            printf("\n");
+        }
+    }
+
+    if (bench_perf_on) bench_perf_close(&bench_perf);
+    bench_free(raw, BENCH_MAX_SIZE);
+    bench_free(enc, buf_len);
+    bench_free(out, buf_len);
+    return 0;
+}
@@ -0,0 +1,79 @@
+/*
+ * File: ref_base64.c
+ * Author: 0xNullll
+ * Description: Vendored reference Base64 codec for the benchmark.
+ * License: MIT
+ */
+
+#include "ref_base64.h"
+
+static const char REF_ENC[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// -1 invalid, -2 padding
+static signed char ref_dec[256];
+static bool ref_dec_ready = false;
+
+static void ref_init(void) {
+    for (int i = 0; i < 256; i++) ref_dec[i] = -1;
+    for (int i = 0; i < 64; i++) ref_dec[(unsigned char)REF_ENC[i]] = (signed char)i;
+    ref_dec['='] = -2;
+    ref_dec_ready = true;
+}
+
+size_t REF_Base64Encode(const uint8_t *data, size_t data_len, char *out) {
+    size_t o = 0;
+    size_t i = 0;
+
+    for (; i + 3 <= data_len; i += 3) {
+        uint32_t v = ((uint32_t)data[i] << 16) | ((uint32_t)data[i + 1] << 8) | data[i + 2];
+        out[o++] = REF_ENC[(v >> 18) & 63];
+        out[o++] = REF_ENC[(v >> 12) & 63];
+        out[o++] = REF_ENC[(v >> 6) & 63];
+        out[o++] = REF_ENC[v & 63];
+    }
+
+    if (i < data_len) {
+        uint32_t v = (uint32_t)data[i] << 16;
+        if (i + 1 < data_len) v |= (uint32_t)data[i + 1] << 8;
+        out[o++] = REF_ENC[(v >> 18) & 63];
+        out[o++] = REF_ENC[(v >> 12) & 63];
+        out[o++] = (i + 1 < data_len) ? REF_ENC[(v >> 6) & 63] : '=';
+        out[o++] = '=';
+    }
+
+    out[o] = '\0';
+    return o;
+}
+
+bool REF_Base64Decode(const char *in, size_t in_len, uint8_t *out, size_t *out_len) {
+    if (!ref_dec_ready) ref_init();
+    if (in_len % 4 != 0) return false;
+
+    size_t o = 0;
+    for (size_t i = 0; i < in_len; i += 4) {
+        int a = ref_dec[(unsigned char)in[i]];
+        int b = ref_dec[(unsigned char)in[i + 1]];
+        int c = ref_dec[(unsigned char)in[i + 2]];
+        int d = ref_dec[(unsigned char)in[i + 3]];
+
+        if (a < 0 || b < 0) return false;
+        out[o++] = (uint8_t)((a << 2) | (b >> 4));
+
+        if (c == -2) {
+            if (d != -2 || i + 4 != in_len) return false;
+            break;
+        }
+        if (c < 0) return false;
+        out[o++] = (uint8_t)((b << 4) | (c >> 2));
+
+        if (d == -2) {
+            if (i + 4 != in_len) return false;
+            break;
+        }
+        if (d < 0) return false;
+        out[o++] = (uint8_t)((c << 6) | d);
+    }
+
+    *out_len = o;
+    return true;
+}
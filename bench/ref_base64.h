@@ -0,0 +1,22 @@
+/*
+ * File: ref_base64.h
+ * Author: 0xNullll
+ * Description: Vendored reference Base64 codec for the benchmark.
+ *              Plain scalar RFC 4648 code in the style of the classic C
+ *              implementations (gnulib / coreutils, BSD): one table lookup
+ *              per char, no SIMD. It is the baseline the Tiny CBase kernels
+ *              are measured against.
+ * License: MIT
+ */
+
+#ifndef REF_BASE64_H
+#define REF_BASE64_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+size_t REF_Base64Encode(const uint8_t *data, size_t data_len, char *out);
+bool REF_Base64Decode(const char *in, size_t in_len, uint8_t *out, size_t *out_len);
+
+#endif // REF_BASE64_H
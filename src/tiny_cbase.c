@@ -14,8 +14,353 @@
 #ifndef TINY_CBASE_IMPLEMENTATION
 #define TINY_CBASE_IMPLEMENTATION
 
+// CPU affinity (cpu_set_t, pthread_setaffinity_np) and syscall() for the NUMA code
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include "tiny_cbase.h"
 
+#include <stdio.h>
+
+//
+// --- SIMD support ---
+//
+// Kernels are picked at compile time from the target flags (-msse2 is the
+// x86-64 baseline, -mavx2 widens some of them). Everything has a scalar
+// fallback, and TINY_CBASE_ENABLE_SIMD=0 forces it.
+#if TINY_CBASE_ENABLE_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TINY_CBASE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if TINY_CBASE_ENABLE_SIMD && defined(__AVX2__)
+#define TINY_CBASE_AVX2 1
+#include <immintrin.h>
+#endif
+
+// AArch64: Advanced SIMD (NEON) kernels, confirmed at runtime through HWCAP
+// on Linux. The byte-interleaving tricks assume little-endian lanes.
+#if TINY_CBASE_ENABLE_SIMD && defined(__aarch64__) && !defined(__ARM_BIG_ENDIAN)
+#define TINY_CBASE_NEON 1
+#include <arm_neon.h>
+#if defined(__linux__)
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+// File descriptor I/O (BASE_EncodeFd); vmsplice into pipes on Linux
+#if defined(__unix__) || defined(__APPLE__)
+#define TINY_CBASE_FDIO 1
+#include <errno.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <fcntl.h>
+#include <sys/uio.h>
+#endif
+#endif
+
+// Worker threads of the parallel encode/decode; NUMA placement is Linux-only
+#if TINY_CBASE_ENABLE_THREADS && (defined(__unix__) || defined(__APPLE__))
+#define TINY_CBASE_THREADS 1
+#include <pthread.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#if defined(__linux__)
+#define TINY_CBASE_NUMA 1
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+// Completion queue wake-ups: an eventfd on Linux, a self-pipe elsewhere
+#if defined(__linux__)
+#define TINY_CBASE_EVENTFD 1
+#include <sys/eventfd.h>
+#endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define BASE_PREFETCH_LINE(p) __builtin_prefetch((p), 0, 3)
+#elif TINY_CBASE_SSE2
+#define BASE_PREFETCH_LINE(p) _mm_prefetch((const char *)(p), _MM_HINT_T0)
+#else
+#define BASE_PREFETCH_LINE(p) ((void)(p))
+#endif
+
+// Index of the lowest set bit (v != 0)
+static FORCE_INLINE unsigned base_ctz32(uint32_t v) {
+#ifdef _MSC_VER
+    unsigned long idx;
+    _BitScanForward(&idx, v);
+    return (unsigned)idx;
+#else
+    return (unsigned)__builtin_ctz(v);
+#endif
+}
+
+// Constant-time masks for BASE_CONST_TIME: all-ones when the condition holds,
+// 0 otherwise, computed without branches (arguments must be < 2^31).
+static FORCE_INLINE uint32_t ct_lt(uint32_t x, uint32_t y) {
+    return 0u - ((x - y) >> 31);
+}
+
+static FORCE_INLINE uint32_t ct_ge(uint32_t x, uint32_t y) {
+    return ~ct_lt(x, y);
+}
+
+static FORCE_INLINE uint32_t ct_eq(uint32_t x, uint32_t y) {
+    return 0u - (((x ^ y) - 1) >> 31);
+}
+
+#if TINY_CBASE_NEON
+// ASIMD is part of the AArch64 base ISA, but kernels and emulators report it
+// in HWCAP; checked once (the race on first use is benign).
+static bool base_neon_available(void) {
+#if defined(__linux__) && defined(HWCAP_ASIMD)
+    static int state = -1;
+    if (state < 0) state = (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+    return state != 0;
+#else
+    return true;
+#endif
+}
+
+static FORCE_INLINE uint8x16x4_t neon_load_table4(const uint8_t *t) {
+    uint8x16x4_t r = {{ vld1q_u8(t), vld1q_u8(t + 16), vld1q_u8(t + 32), vld1q_u8(t + 48) }};
+    return r;
+}
+
+// 128-entry table lookup (lo: chars 0-63, hi: 64-127), 0xFF marks invalid.
+// Invalid entries and chars >= 0x80 set the top bit of *bad.
+static FORCE_INLINE uint8x16_t neon_lookup128(const uint8x16x4_t *lo, const uint8x16x4_t *hi, uint8x16_t c, uint8x16_t *bad) {
+    uint8x16_t v = vorrq_u8(vqtbl4q_u8(*lo, c), vqtbl4q_u8(*hi, vsubq_u8(c, vdupq_n_u8(64))));
+    *bad = vorrq_u8(*bad, vorrq_u8(v, c));
+    return v;
+}
+
+static FORCE_INLINE bool neon_any_bad(uint8x16_t bad) {
+    return (vmaxvq_u8(bad) & 0x80) != 0;
+}
+
+// Lane g of vector j <- byte 5g + j of an 80-byte block (16 groups of 5)
+static const uint8_t NEON_GATHER5[5][16] = {
+    {  0,  5, 10, 15, 20, 25, 30, 35, 40, 45, 50, 55, 60, 65, 70, 75 },
+    {  1,  6, 11, 16, 21, 26, 31, 36, 41, 46, 51, 56, 61, 66, 71, 76 },
+    {  2,  7, 12, 17, 22, 27, 32, 37, 42, 47, 52, 57, 62, 67, 72, 77 },
+    {  3,  8, 13, 18, 23, 28, 33, 38, 43, 48, 53, 58, 63, 68, 73, 78 },
+    {  4,  9, 14, 19, 24, 29, 34, 39, 44, 49, 54, 59, 64, 69, 74, 79 },
+};
+
+// Byte 16m + l of an 80-byte block <- lane g of vector j, as index 16j + g
+static const uint8_t NEON_SCATTER5[5][16] = {
+    {  0, 16, 32, 48, 64,  1, 17, 33, 49, 65,  2, 18, 34, 50, 66,  3 },
+    { 19, 35, 51, 67,  4, 20, 36, 52, 68,  5, 21, 37, 53, 69,  6, 22 },
+    { 38, 54, 70,  7, 23, 39, 55, 71,  8, 24, 40, 56, 72,  9, 25, 41 },
+    { 57, 73, 10, 26, 42, 58, 74, 11, 27, 43, 59, 75, 12, 28, 44, 60 },
+    { 76, 13, 29, 45, 61, 77, 14, 30, 46, 62, 78, 15, 31, 47, 63, 79 },
+};
+
+// 80 bytes -> 5 vectors: lane g of out[j] is p[5g + j] (Base32 and Z85 groups)
+static FORCE_INLINE void neon_gather5(const uint8_t *p, uint8x16_t out[5]) {
+    uint8x16x4_t t = neon_load_table4(p);
+    uint8x16_t t4 = vld1q_u8(p + 64);
+    for (int j = 0; j < 5; j++) {
+        uint8x16_t idx = vld1q_u8(NEON_GATHER5[j]);
+        out[j] = vqtbx1q_u8(vqtbl4q_u8(t, idx), t4, vsubq_u8(idx, vdupq_n_u8(64)));
+    }
+}
+
+// Inverse of neon_gather5
+static FORCE_INLINE void neon_scatter5(const uint8x16_t in[5], uint8_t *p) {
+    uint8x16x4_t t = {{ in[0], in[1], in[2], in[3] }};
+    for (int m = 0; m < 5; m++) {
+        uint8x16_t idx = vld1q_u8(NEON_SCATTER5[m]);
+        vst1q_u8(p + 16 * m, vqtbx1q_u8(vqtbl4q_u8(t, idx), in[4], vsubq_u8(idx, vdupq_n_u8(64))));
+    }
+}
+#endif // TINY_CBASE_NEON
+
+// Prefetches the input BASE_PREFETCH_DISTANCE bytes ahead of pos, for a loop
+// advancing `step` bytes per iteration: once per 64-byte line for small steps,
+// every line of the step for wide ones. Stops short of the end of the input.
+static FORCE_INLINE void base_prefetch(const void *data, size_t pos, size_t len, size_t step) {
+#if BASE_PREFETCH_DISTANCE > 0
+    if (len - pos < BASE_PREFETCH_DISTANCE + step) return;
+
+    const char *p = (const char *)data + pos + BASE_PREFETCH_DISTANCE;
+    if (step >= 64) {
+        for (size_t k = 0; k < step; k += 64) BASE_PREFETCH_LINE(p + k);
+    } else if ((pos & 63) < step) {
+        BASE_PREFETCH_LINE(p);
+    }
+#else
+    (void)data;
+    (void)pos;
+    (void)len;
+    (void)step;
+#endif
+}
+
+// ASCII whitespace (' ', '\t', '\n', '\v', '\f', '\r'), independent of the locale
+static FORCE_INLINE bool base_is_space(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+// Failure path of the decoders: records why and where, when the caller asked.
+// Kept out of line so the success path does not pay for it.
+static bool base_fail(BASE_Error *err, BASE_ErrorCode reason, const char *data, size_t offset) {
+    if (err) {
+        err->reason = reason;
+        err->offset = offset;
+        err->ch = (reason == BASE_ERR_INVALID_CHAR || reason == BASE_ERR_BAD_PADDING) ? data[offset] : 0;
+    }
+    return false;
+}
+
+// --- Streaming (non-temporal) stores for large outputs ---
+#if TINY_CBASE_THREADS
+// Pool workers read it while another thread may set it; relaxed is enough for a tuning knob
+static _Atomic size_t base_stream_threshold = BASE_STREAM_THRESHOLD_DEFAULT;
+
+void BASE_SetStreamThreshold(size_t bytes) {
+    atomic_store_explicit(&base_stream_threshold, bytes, memory_order_relaxed);
+}
+
+size_t BASE_GetStreamThreshold(void) {
+    return atomic_load_explicit(&base_stream_threshold, memory_order_relaxed);
+}
+#else
+static size_t base_stream_threshold = BASE_STREAM_THRESHOLD_DEFAULT;
+
+void BASE_SetStreamThreshold(size_t bytes) {
+    base_stream_threshold = bytes;
+}
+
+size_t BASE_GetStreamThreshold(void) {
+    return base_stream_threshold;
+}
+#endif
+
+#if TINY_CBASE_SSE2
+#define TINY_CBASE_STREAM 1
+#endif
+
+// One codec call on a piece of the input (adapters over the codec entry points),
+// used by the streaming and parallel drivers
+typedef bool (*base_chunk_fn)(const uint8_t *in, size_t in_len, uint8_t *out, size_t *out_len, int mode_flags, BASE_Error *err);
+
+#if TINY_CBASE_STREAM
+
+// Output staged per chunk; small enough to stay in L1
+#define BASE_STREAM_STAGE 8192
+
+// Chunks never exceed the stage, so the calls base_stream_run makes do not stream again
+static FORCE_INLINE bool base_stream_wanted(size_t out_len) {
+    return out_len > BASE_STREAM_STAGE && out_len >= BASE_GetStreamThreshold();
+}
+
+// memcpy with non-temporal stores: the destination lines bypass the cache
+static void base_stream_copy(uint8_t *dst, const uint8_t *src, size_t n) {
+    while (n && ((uintptr_t)dst & 15)) {
+        *dst++ = *src++;
+        n--;
+    }
+    for (; n >= 64; n -= 64, dst += 64, src += 64) {
+        _mm_stream_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+        _mm_stream_si128((__m128i *)(dst + 16), _mm_loadu_si128((const __m128i *)(src + 16)));
+        _mm_stream_si128((__m128i *)(dst + 32), _mm_loadu_si128((const __m128i *)(src + 32)));
+        _mm_stream_si128((__m128i *)(dst + 48), _mm_loadu_si128((const __m128i *)(src + 48)));
+    }
+    for (; n >= 16; n -= 16, dst += 16, src += 16) {
+        _mm_stream_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+    }
+    memcpy(dst, src, n);
+}
+
+// Runs fn over chunks of whole quanta (in_q input -> out_q output units) into a
+// cache-resident stage and streams each result to out. The last chunk, which
+// carries the padding and the encoders' '\0', is written in place. Only for
+// codecs whose quanta decode independently, so chunking cannot change results.
+static bool base_stream_run(base_chunk_fn fn, const uint8_t *in, size_t in_len, uint8_t *out, size_t *out_len,
+                            int mode_flags, BASE_Error *err, size_t in_q, size_t out_q) {
+    uint8_t stage[BASE_STREAM_STAGE + 1]; // +1 for the encoders' '\0'
+    size_t chunk = BASE_STREAM_STAGE / out_q * in_q;
+    size_t i = 0, o = 0, n = 0;
+
+    for (; in_len - i > chunk; i += chunk) {
+        if (!fn(in + i, chunk, stage, &n, mode_flags, err)) break;
+        base_stream_copy(out + o, stage, n);
+        o += n;
+    }
+    _mm_sfence(); // order the streamed lines before anything the caller does next
+
+    if (in_len - i <= chunk && fn(in + i, in_len - i, out + o, &n, mode_flags, err)) {
+        *out_len = o + n;
+        return true;
+    }
+    if (err) err->offset += i; // offsets are relative to the failing chunk
+    return false;
+}
+
+#endif // TINY_CBASE_STREAM
+
+// --- Large buffers ---
+#if defined(__linux__) && defined(MAP_ANONYMOUS) && defined(MADV_HUGEPAGE)
+#define TINY_CBASE_HUGEPAGES 1
+#endif
+
+void *BASE_AllocBuffer(size_t size) {
+    if (size == 0) return NULL;
+
+#if TINY_CBASE_HUGEPAGES
+    if (size >= BASE_HUGEPAGE_SIZE && size <= SIZE_MAX - 2 * BASE_HUGEPAGE_SIZE) {
+        // Over-map by one huge page and trim, so the buffer starts 2 MiB aligned
+        size_t len = (size + BASE_HUGEPAGE_SIZE - 1) & ~(BASE_HUGEPAGE_SIZE - 1);
+        size_t map_len = len + BASE_HUGEPAGE_SIZE;
+        uint8_t *map = mmap(NULL, map_len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (map == MAP_FAILED) return NULL;
+
+        uint8_t *buf = (uint8_t *)(((uintptr_t)map + BASE_HUGEPAGE_SIZE - 1) & ~(uintptr_t)(BASE_HUGEPAGE_SIZE - 1));
+        size_t head = (size_t)(buf - map);
+        if (head) munmap(map, head);
+        if (map_len - head > len) munmap(buf + len, map_len - head - len);
+
+        madvise(buf, len, MADV_HUGEPAGE); // a hint: without THP the pages stay 4 KiB
+        return buf;
+    }
+#endif
+
+    return malloc(size);
+}
+
+void BASE_FreeBuffer(void *buf, size_t size) {
+    if (!buf) return;
+
+#if TINY_CBASE_HUGEPAGES
+    if (size >= BASE_HUGEPAGE_SIZE && size <= SIZE_MAX - 2 * BASE_HUGEPAGE_SIZE) {
+        munmap(buf, (size + BASE_HUGEPAGE_SIZE - 1) & ~(BASE_HUGEPAGE_SIZE - 1));
+        return;
+    }
+#else
+    (void)size;
+#endif
+
+    free(buf);
+}
+
 #if TINY_CBASE_ENABLE_BASE16
 
 // Hex encoding table
@@ -49,16 +394,225 @@ static const int8_t BASE16_REV_TABLE[] = {
 };
 
 
+// Constant-time mapping (BASE_CONST_TIME), scalar parts.
+static FORCE_INLINE char base16_ct_char(uint32_t nibble, bool lower) {
+    return (char)(nibble + '0' + (ct_lt(9, nibble) & (lower ? 39u : 7u)));
+}
+
+// Returns the 4-bit value of c; *invalid collects all-ones for non-hex chars.
+static FORCE_INLINE uint32_t base16_ct_value(uint32_t c, uint32_t *invalid) {
+    uint32_t digit = ct_ge(c, '0') & ct_lt(c, '9' + 1);
+    uint32_t alpha = c | 0x20; // fold case
+    uint32_t hex = ct_ge(alpha, 'a') & ct_lt(alpha, 'f' + 1);
+
+    *invalid |= ~(digit | hex);
+    return (digit & (c - '0')) | (hex & (alpha - 'a' + 10));
+}
+
+#if TINY_CBASE_SSE2
+
+// 16 bytes -> 32 hex chars with compares and adds, no table lookups
+static FORCE_INLINE void base16_encode_ct_sse2(const uint8_t *in, char *out, bool lower) {
+    __m128i v = _mm_loadu_si128((const __m128i *)in);
+    __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), _mm_set1_epi8(0x0F));
+    __m128i lo = _mm_and_si128(v, _mm_set1_epi8(0x0F));
+    __m128i nine = _mm_set1_epi8(9);
+    __m128i adj = _mm_set1_epi8(lower ? 39 : 7);
+
+    hi = _mm_add_epi8(_mm_add_epi8(hi, _mm_set1_epi8('0')), _mm_and_si128(_mm_cmpgt_epi8(hi, nine), adj));
+    lo = _mm_add_epi8(_mm_add_epi8(lo, _mm_set1_epi8('0')), _mm_and_si128(_mm_cmpgt_epi8(lo, nine), adj));
+
+    _mm_storeu_si128((__m128i *)out, _mm_unpacklo_epi8(hi, lo));
+    _mm_storeu_si128((__m128i *)(out + 16), _mm_unpackhi_epi8(hi, lo));
+}
+
+// Maps 16 hex chars to nibbles; `invalid` collects 0xFF for non-hex chars
+static FORCE_INLINE __m128i base16_values_ct_sse2(__m128i c, __m128i *invalid) {
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+    __m128i alpha = _mm_or_si128(c, _mm_set1_epi8(0x20));
+    __m128i hex = _mm_and_si128(_mm_cmpgt_epi8(alpha, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(alpha, _mm_set1_epi8('f' + 1)));
+
+    *invalid = _mm_or_si128(*invalid, _mm_andnot_si128(_mm_or_si128(digit, hex), _mm_set1_epi8(-1)));
+    return _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(c, _mm_set1_epi8('0'))),
+                        _mm_and_si128(hex, _mm_sub_epi8(alpha, _mm_set1_epi8('a' - 10))));
+}
+
+// 32 hex chars -> 16 bytes: nibble pairs are merged in 16-bit lanes
+static FORCE_INLINE void base16_decode_ct_sse2(const char *in, uint8_t *out, __m128i *invalid) {
+    __m128i n0 = base16_values_ct_sse2(_mm_loadu_si128((const __m128i *)in), invalid);
+    __m128i n1 = base16_values_ct_sse2(_mm_loadu_si128((const __m128i *)(in + 16)), invalid);
+    __m128i b0 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n0, _mm_set1_epi16(0x00FF)), 4), _mm_srli_epi16(n0, 8));
+    __m128i b1 = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(n1, _mm_set1_epi16(0x00FF)), 4), _mm_srli_epi16(n1, 8));
+
+    _mm_storeu_si128((__m128i *)out, _mm_packus_epi16(b0, b1));
+}
+
+#endif // TINY_CBASE_SSE2
+
+#if TINY_CBASE_NEON
+
+// 16 bytes -> 32 hex chars, nibbles interleaved by the 2-way store
+static FORCE_INLINE void base16_encode_neon(const uint8_t *in, char *out, const char *table) {
+    uint8x16_t t = vld1q_u8((const uint8_t *)table);
+    uint8x16_t v = vld1q_u8(in);
+    uint8x16x2_t r;
+
+    r.val[0] = vqtbl1q_u8(t, vshrq_n_u8(v, 4));
+    r.val[1] = vqtbl1q_u8(t, vandq_u8(v, vdupq_n_u8(0x0F)));
+    vst2q_u8((uint8_t *)out, r);
+}
+
+// Maps 16 hex chars to nibbles; `bad` collects 0xFF for non-hex chars
+static FORCE_INLINE uint8x16_t base16_values_neon(uint8x16_t c, uint8x16_t *bad) {
+    uint8x16_t d = vsubq_u8(c, vdupq_n_u8('0'));
+    uint8x16_t a = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+    uint8x16_t digit = vcltq_u8(d, vdupq_n_u8(10));
+    uint8x16_t hex = vcltq_u8(a, vdupq_n_u8(6));
+
+    *bad = vorrq_u8(*bad, vmvnq_u8(vorrq_u8(digit, hex)));
+    return vbslq_u8(digit, d, vaddq_u8(a, vdupq_n_u8(10)));
+}
+
+// 32 hex chars -> 16 bytes; stores nothing and returns false on a non-hex char
+static FORCE_INLINE bool base16_decode_neon(const char *in, uint8_t *out) {
+    uint8x16x2_t c = vld2q_u8((const uint8_t *)in);
+    uint8x16_t bad = vdupq_n_u8(0);
+    uint8x16_t hi = base16_values_neon(c.val[0], &bad);
+    uint8x16_t lo = base16_values_neon(c.val[1], &bad);
+
+    if (neon_any_bad(bad)) return false;
+    vst1q_u8(out, vorrq_u8(vshlq_n_u8(hi, 4), lo));
+    return true;
+}
+
+#endif // TINY_CBASE_NEON
+
+static bool base16_encode_ct(const uint8_t *raw_data, size_t raw_len, char *out_encoded, size_t *out_encoded_len, bool lower) {
+    size_t i = 0;
+
+#if TINY_CBASE_SSE2
+    for (; raw_len - i >= 16; i += 16) {
+        base_prefetch(raw_data, i, raw_len, 16);
+        base16_encode_ct_sse2(raw_data + i, out_encoded + i * 2, lower);
+    }
+#endif
+
+    for (; i < raw_len; i++) {
+        out_encoded[i * 2] = base16_ct_char(raw_data[i] >> 4, lower);
+        out_encoded[i * 2 + 1] = base16_ct_char(raw_data[i] & 0x0F, lower);
+    }
+
+    out_encoded[raw_len * 2] = '\0';
+    *out_encoded_len = raw_len * 2;
+    return true;
+}
+
+// First non-hex char at or after i. Failure path only: the constant-time loop
+// does not know where the bad char was, so the input is re-scanned.
+static size_t base16_find_invalid(const char *encoded_data, size_t encoded_len) {
+    size_t i = 0;
+    while (i < encoded_len) {
+        char c = encoded_data[i];
+        if (c < BASE16_MIN || c > BASE16_MAX || BASE16_REV_TABLE[c - BASE16_MIN] < 0) break;
+        i++;
+    }
+    return i;
+}
+
+static bool base16_decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, BASE_Error *err);
+static bool base16_decode_ct(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, BASE_Error *err);
+
+static bool base16_encode_chunk(const uint8_t *in, size_t in_len, uint8_t *out, size_t *out_len, int mode_flags, BASE_Error *err) {
+    (void)err;
+    return BASE16_Encode(in, in_len, (char *)out, out_len, mode_flags);
+}
+
+static bool base16_decode_chunk(const uint8_t *in, size_t in_len, uint8_t *out, size_t *out_len, int mode_flags, BASE_Error *err) {
+    if (mode_flags & BASE_CONST_TIME) return base16_decode_ct((const char *)in, in_len, out, out_len, err);
+    return base16_decode((const char *)in, in_len, out, out_len, err);
+}
+
+static bool base16_decode_ct(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, BASE_Error *err) {
+    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len) return base_fail(err, BASE_ERR_ARGS, NULL, 0);
+
+#if BASE_TRUNCATE_ON_NULL
+    for (size_t i = 0; i < encoded_len; ++i) {
+        if (encoded_data[i] == '\0') {
+            encoded_len = i;
+            break;
+        }
+    }
+#endif
+
+    if (encoded_len % 2 != 0) return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, encoded_len);
+
+#if TINY_CBASE_STREAM
+    if (base_stream_wanted(encoded_len / 2)) {
+        return base_stream_run(base16_decode_chunk, (const uint8_t *)encoded_data, encoded_len, out_decoded, out_decoded_len,
+                               BASE_CONST_TIME, err, 2, 1);
+    }
+#endif
+
+    size_t i = 0;
+    uint32_t invalid = 0;
+
+#if TINY_CBASE_SSE2
+    __m128i bad = _mm_setzero_si128();
+    for (; encoded_len - i >= 32; i += 32) {
+        base_prefetch(encoded_data, i, encoded_len, 32);
+        base16_decode_ct_sse2(encoded_data + i, out_decoded + i / 2, &bad);
+    }
+    invalid |= (uint32_t)_mm_movemask_epi8(bad);
+#endif
+
+    for (; i < encoded_len; i += 2) {
+        uint32_t hi = base16_ct_value((unsigned char)encoded_data[i], &invalid);
+        uint32_t lo = base16_ct_value((unsigned char)encoded_data[i + 1], &invalid);
+        out_decoded[i / 2] = (uint8_t)((hi << 4) | lo);
+    }
+
+    // Single check at the end, no early exit on the first bad char
+    if (invalid) return base_fail(err, BASE_ERR_INVALID_CHAR, encoded_data, base16_find_invalid(encoded_data, encoded_len));
+
+    *out_decoded_len = encoded_len / 2;
+    return true;
+}
+
+bool BASE16_DecodeConstTime(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
+    return base16_decode_ct(encoded_data, encoded_len, out_decoded, out_decoded_len, NULL);
+}
+
 bool BASE16_Encode(const uint8_t *raw_data, size_t raw_len, char *out_encoded, size_t *out_encoded_len, int mode_flags) {
     if (!raw_data || raw_len == 0 || !out_encoded || !out_encoded_len) return false;
 
-    const char *table = (mode_flags == BASE16_LOWER || mode_flags == BASE16_UPPER)
+#if TINY_CBASE_STREAM
+    if (base_stream_wanted(raw_len * 2)) {
+        return base_stream_run(base16_encode_chunk, raw_data, raw_len, (uint8_t *)out_encoded, out_encoded_len, mode_flags, NULL, 1, 2);
+    }
+#endif
+
+    if (mode_flags & BASE_CONST_TIME) {
+        return base16_encode_ct(raw_data, raw_len, out_encoded, out_encoded_len, (mode_flags & BASE16_LOWER) != 0);
+    }
+
+    const char *table = (mode_flags & BASE16_LOWER)
                         ? BASE16_ENC_TABLE_LOWER
                         : BASE16_ENC_TABLE_UPPER;
 
     size_t out_index = 0;
+    size_t i = 0;
+
+#if TINY_CBASE_NEON
+    if (base_neon_available()) {
+        for (; raw_len - i >= 16; i += 16) {
+            base_prefetch(raw_data, i, raw_len, 16);
+            base16_encode_neon(raw_data + i, out_encoded + i * 2, table);
+        }
+        out_index = i * 2;
+    }
+#endif
 
-    for (size_t i = 0; i < raw_len; i++) {
+    for (; i < raw_len; i++) {
         uint8_t byte = raw_data[i];
         out_encoded[out_index++] = table[(byte >> 4) & 0x0F];
         out_encoded[out_index++] = table[byte & 0x0F];
@@ -69,8 +623,8 @@ bool BASE16_Encode(const uint8_t *raw_data, size_t raw_len, char *out_encoded, s
     return true;
 }
 
-bool BASE16_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
-    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len) return false;
+static bool base16_decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, BASE_Error *err) {
+    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len) return base_fail(err, BASE_ERR_ARGS, NULL, 0);
 
 #if BASE_TRUNCATE_ON_NULL
     for (size_t i = 0; i < encoded_len; ++i) {
@@ -81,15 +635,34 @@ bool BASE16_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
     }
 #endif
 
-    if (encoded_len % 2 != 0) return false;
+    if (encoded_len % 2 != 0) return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, encoded_len);
+
+#if TINY_CBASE_STREAM
+    if (base_stream_wanted(encoded_len / 2)) {
+        return base_stream_run(base16_decode_chunk, (const uint8_t *)encoded_data, encoded_len, out_decoded, out_decoded_len, 0, err, 2, 1);
+    }
+#endif
 
     size_t out_index = 0;
-    for (size_t i = 0; i < encoded_len; i += 2) {
+    size_t i = 0;
+
+#if TINY_CBASE_NEON
+    // A block with a bad char falls through to the scalar loop, which reports it
+    if (base_neon_available()) {
+        for (; encoded_len - i >= 32; i += 32) {
+            base_prefetch(encoded_data, i, encoded_len, 32);
+            if (!base16_decode_neon(encoded_data + i, out_decoded + i / 2)) break;
+        }
+        out_index = i / 2;
+    }
+#endif
+
+    for (; i < encoded_len; i += 2) {
         char c1 = encoded_data[i];
         char c2 = encoded_data[i + 1];
         int8_t hi = (c1 >= BASE16_MIN && c1 <= BASE16_MAX) ? BASE16_REV_TABLE[c1 - BASE16_MIN] : -1;
         int8_t lo = (c2 >= BASE16_MIN && c2 <= BASE16_MAX) ? BASE16_REV_TABLE[c2 - BASE16_MIN] : -1;
-        if (hi < 0 || lo < 0) return false;
+        if (hi < 0 || lo < 0) return base_fail(err, BASE_ERR_INVALID_CHAR, encoded_data, hi < 0 ? i : i + 1);
 
         out_decoded[out_index++] = (uint8_t)((hi << 4) | lo);
     }
@@ -98,6 +671,10 @@ bool BASE16_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
     return true;
 }
 
+bool BASE16_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
+    return base16_decode(encoded_data, encoded_len, out_decoded, out_decoded_len, NULL);
+}
+
 #endif // TINY_CBASE_ENABLE_BASE16
 
 #if TINY_CBASE_ENABLE_BASE32
@@ -125,14 +702,111 @@ static const int8_t BASE32_REV_TABLE[] = {
     0,1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,17,18,19,20,21,22,23,24,25
 };
 
+#if TINY_CBASE_NEON
+
+// Full 7-bit reverse table for the NEON lookups, 0xFF marks invalid (incl. '=')
+static const uint8_t BASE32_NEON_REV_TABLE[128] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+// 80 bytes -> 128 chars (16 groups of 5 bytes / 8 chars)
+static FORCE_INLINE void base32_encode_neon(const uint8_t *in, char *out) {
+    const uint8x16x2_t t = {{ vld1q_u8((const uint8_t *)BASE32_ENC_TABLE), vld1q_u8((const uint8_t *)BASE32_ENC_TABLE + 16) }};
+    const uint8x16_t m5 = vdupq_n_u8(0x1F);
+    uint8x16_t b[5], c[8];
+
+    neon_gather5(in, b);
+    c[0] = vshrq_n_u8(b[0], 3);
+    c[1] = vorrq_u8(vshlq_n_u8(vandq_u8(b[0], vdupq_n_u8(0x07)), 2), vshrq_n_u8(b[1], 6));
+    c[2] = vandq_u8(vshrq_n_u8(b[1], 1), m5);
+    c[3] = vorrq_u8(vshlq_n_u8(vandq_u8(b[1], vdupq_n_u8(0x01)), 4), vshrq_n_u8(b[2], 4));
+    c[4] = vorrq_u8(vshlq_n_u8(vandq_u8(b[2], vdupq_n_u8(0x0F)), 1), vshrq_n_u8(b[3], 7));
+    c[5] = vandq_u8(vshrq_n_u8(b[3], 2), m5);
+    c[6] = vorrq_u8(vshlq_n_u8(vandq_u8(b[3], vdupq_n_u8(0x03)), 3), vshrq_n_u8(b[4], 5));
+    c[7] = vandq_u8(b[4], m5);
+
+    // Char pairs become 16-bit lanes, a 4-way store then yields 8 chars per group
+    uint16x8x4_t lo, hi;
+    for (int k = 0; k < 4; k++) {
+        uint8x16_t e = vqtbl2q_u8(t, c[2 * k]);
+        uint8x16_t o = vqtbl2q_u8(t, c[2 * k + 1]);
+        lo.val[k] = vreinterpretq_u16_u8(vzip1q_u8(e, o));
+        hi.val[k] = vreinterpretq_u16_u8(vzip2q_u8(e, o));
+    }
+    vst4q_u16((uint16_t *)out, lo);
+    vst4q_u16((uint16_t *)(out + 64), hi);
+}
+
+// 128 chars -> 80 bytes; stores nothing and returns false on a bad char or '='
+static FORCE_INLINE bool base32_decode_neon(const char *in, uint8_t *out) {
+    const uint8x16x4_t t0 = neon_load_table4(BASE32_NEON_REV_TABLE);
+    const uint8x16x4_t t1 = neon_load_table4(BASE32_NEON_REV_TABLE + 64);
+    uint16x8x4_t lo = vld4q_u16((const uint16_t *)in);
+    uint16x8x4_t hi = vld4q_u16((const uint16_t *)(in + 64));
+    uint8x16_t bad = vdupq_n_u8(0);
+    uint8x16_t c[8], b[5];
+
+    for (int k = 0; k < 4; k++) {
+        uint8x16_t l = vreinterpretq_u8_u16(lo.val[k]);
+        uint8x16_t h = vreinterpretq_u8_u16(hi.val[k]);
+        c[2 * k] = neon_lookup128(&t0, &t1, vuzp1q_u8(l, h), &bad);
+        c[2 * k + 1] = neon_lookup128(&t0, &t1, vuzp2q_u8(l, h), &bad);
+    }
+    if (neon_any_bad(bad)) return false;
+
+    b[0] = vorrq_u8(vshlq_n_u8(c[0], 3), vshrq_n_u8(c[1], 2));
+    b[1] = vorrq_u8(vorrq_u8(vshlq_n_u8(c[1], 6), vshlq_n_u8(c[2], 1)), vshrq_n_u8(c[3], 4));
+    b[2] = vorrq_u8(vshlq_n_u8(c[3], 4), vshrq_n_u8(c[4], 1));
+    b[3] = vorrq_u8(vorrq_u8(vshlq_n_u8(c[4], 7), vshlq_n_u8(c[5], 2)), vshrq_n_u8(c[6], 3));
+    b[4] = vorrq_u8(vshlq_n_u8(c[6], 5), c[7]);
+    neon_scatter5(b, out);
+    return true;
+}
+
+#endif // TINY_CBASE_NEON
+
+static bool base32_decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags, BASE_Error *err);
+
+static bool base32_encode_chunk(const uint8_t *in, size_t in_len, uint8_t *out, size_t *out_len, int mode_flags, BASE_Error *err) {
+    (void)err;
+    return BASE32_Encode(in, in_len, (char *)out, out_len, mode_flags);
+}
+
+static bool base32_decode_chunk(const uint8_t *in, size_t in_len, uint8_t *out, size_t *out_len, int mode_flags, BASE_Error *err) {
+    return base32_decode((const char *)in, in_len, out, out_len, mode_flags, err);
+}
 
 bool BASE32_Encode(const uint8_t *raw_data, size_t raw_len, char *out_encoded, size_t *out_encoded_len, int mode_flags) {
     if (!raw_data || raw_len == 0 || !out_encoded || !out_encoded_len) return false;
 
+#if TINY_CBASE_STREAM
+    if (base_stream_wanted(raw_len / 5 * 8)) {
+        return base_stream_run(base32_encode_chunk, raw_data, raw_len, (uint8_t *)out_encoded, out_encoded_len, mode_flags, NULL, 5, 8);
+    }
+#endif
+
     size_t out_index = 0;
     int no_pad = ((mode_flags & BASE32_ENC_NOPAD) != 0);
+    size_t i = 0;
+
+#if TINY_CBASE_NEON
+    if (base_neon_available()) {
+        for (; raw_len - i >= 80; i += 80) {
+            base_prefetch(raw_data, i, raw_len, 80);
+            base32_encode_neon(raw_data + i, out_encoded + i / 5 * 8);
+        }
+        out_index = i / 5 * 8;
+    }
+#endif
 
-    for (size_t i = 0; i < raw_len; i += 5) {
+    for (; i < raw_len; i += 5) {
         uint8_t in0 = raw_data[i];
         uint8_t in1 = (i + 1 < raw_len) ? raw_data[i + 1] : 0;
         uint8_t in2 = (i + 2 < raw_len) ? raw_data[i + 2] : 0;
@@ -156,8 +830,8 @@ bool BASE32_Encode(const uint8_t *raw_data, size_t raw_len, char *out_encoded, s
     return true;
 }
 
-bool BASE32_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags) {
-    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len) return false;
+static bool base32_decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags, BASE_Error *err) {
+    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len) return base_fail(err, BASE_ERR_ARGS, NULL, 0);
 
 #if BASE_TRUNCATE_ON_NULL
     // Adjust encoded_len if null terminator appears before
@@ -170,18 +844,36 @@ bool BASE32_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
 #endif // BASE_TRUNCATE_ON_NULL
 
     int no_pad = ((mode_flags & BASE32_DEC_NOPAD) != 0);
-    if (!no_pad && encoded_len % 8 != 0) return false;
+    if (!no_pad && encoded_len % 8 != 0) return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, encoded_len);
+
+#if TINY_CBASE_STREAM
+    if (base_stream_wanted(encoded_len / 8 * 5)) {
+        return base_stream_run(base32_decode_chunk, (const uint8_t *)encoded_data, encoded_len, out_decoded, out_decoded_len, mode_flags, err, 8, 5);
+    }
+#endif
 
     size_t out_index = 0;
     uint64_t buf;
+    size_t i = 0;
+
+#if TINY_CBASE_NEON
+    // Padding or a bad char ends the vector loop; the scalar loop takes over there
+    if (base_neon_available()) {
+        for (; encoded_len - i >= 128; i += 128) {
+            base_prefetch(encoded_data, i, encoded_len, 128);
+            if (!base32_decode_neon(encoded_data + i, out_decoded + i / 8 * 5)) break;
+        }
+        out_index = i / 8 * 5;
+    }
+#endif
 
-    for (size_t i = 0; i < encoded_len; i += 8) {
+    for (; i < encoded_len; i += 8) {
         buf = 0;
         int valid_chars = 0;
         for (int j = 0; j < 8; j++) {
             char c = (i + (size_t)j < encoded_len) ? encoded_data[i + (size_t)j] : BASE32_PAD_CHAR;
             int8_t val = (c == BASE32_PAD_CHAR) ? 0 : (c >= BASE32_MIN && c <= BASE32_MAX) ? BASE32_REV_TABLE[c - BASE32_MIN] : -1;
-            if (val < 0) return false;
+            if (val < 0) return base_fail(err, BASE_ERR_INVALID_CHAR, encoded_data, i + (size_t)j);
             buf = (buf << 5) | (uint64_t)val;
             if (c != BASE32_PAD_CHAR) valid_chars++;
         }
@@ -197,6 +889,10 @@ bool BASE32_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
     return true;
 }
 
+bool BASE32_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags) {
+    return base32_decode(encoded_data, encoded_len, out_decoded, out_decoded_len, mode_flags, NULL);
+}
+
 #endif // TINY_CBASE_ENABLE_BASE32
 
 #if TINY_CBASE_ENABLE_BASE58
@@ -268,8 +964,8 @@ bool BASE58_Encode(const uint8_t *raw_data, size_t raw_len, char *out_encoded, s
     return true;
 }
 
-bool BASE58_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
-    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len) return false;
+static bool base58_decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, BASE_Error *err) {
+    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len) return base_fail(err, BASE_ERR_ARGS, NULL, 0);
 
 #if BASE_TRUNCATE_ON_NULL
     // Adjust encoded_len if null terminator appears before
@@ -295,7 +991,7 @@ bool BASE58_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
         int val = -1;
         char c = encoded_data[i];
         if (c >= BASE58_MIN && c <= BASE58_MAX) val = BASE58_REV_TABLE[c - BASE58_MIN]; // reverse lookup
-        if (val < 0) return false; // invalid char
+        if (val < 0) return base_fail(err, BASE_ERR_INVALID_CHAR, encoded_data, i);
 
         for (size_t j = size - 1; j != (size_t)-1; --j) {
             val += 58 * buf[j];
@@ -320,6 +1016,10 @@ bool BASE58_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
     return true;
 }
 
+bool BASE58_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
+    return base58_decode(encoded_data, encoded_len, out_decoded, out_decoded_len, NULL);
+}
+
 #endif // TINY_CBASE_ENABLE_BASE58
 
 #if TINY_CBASE_ENABLE_BASE64
@@ -363,25 +1063,313 @@ static const int8_t BASE64_REV_URL_SAFE_TABLE[] = {
     50,51
 };
 
-bool BASE64_Encode(const uint8_t *raw_data, size_t raw_len, char *out_encoded, size_t *out_encoded_len, int mode_flags) {
-    if (!raw_data || raw_len == 0 || !out_encoded || !out_encoded_len) return false;
+#if TINY_CBASE_NEON
+
+// Full 7-bit reverse tables for the NEON lookups, 0xFF marks invalid (incl. '=')
+static const uint8_t BASE64_NEON_REV_TABLE[128] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF, 0xFF, 0x3F,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
 
-    bool url_safe = (mode_flags & BASE64_URL_ENC) != 0;
-    bool no_pad   = (mode_flags & BASE64_NOPAD_ENC) != 0;
+static const uint8_t BASE64_NEON_REV_URL_SAFE_TABLE[128] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x3E, 0xFF, 0xFF,
+    0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+    0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0xFF, 0xFF, 0xFF, 0xFF, 0x3F,
+    0xFF, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+    0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
 
-    const char *enc_table = url_safe ? BASE64_URL_SAFE_TABLE : BASE64_ENC_TABLE;
-    size_t out_index = 0;
+// 48 bytes -> 64 chars; `t` holds the 64-char alphabet
+static FORCE_INLINE void base64_encode_neon(const uint8_t *in, char *out, const uint8x16x4_t *t) {
+    const uint8x16_t m6 = vdupq_n_u8(0x3F);
+    uint8x16x3_t v = vld3q_u8(in);
+    uint8x16x4_t s;
+
+    s.val[0] = vshrq_n_u8(v.val[0], 2);
+    s.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(v.val[0], 4), vshrq_n_u8(v.val[1], 4)), m6);
+    s.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(v.val[1], 2), vshrq_n_u8(v.val[2], 6)), m6);
+    s.val[3] = vandq_u8(v.val[2], m6);
+    for (int k = 0; k < 4; k++) s.val[k] = vqtbl4q_u8(*t, s.val[k]);
+    vst4q_u8((uint8_t *)out, s);
+}
 
-    for (size_t i = 0; i < raw_len; i += 3) {
-        uint8_t byte0 = raw_data[i];
-        uint8_t byte1 = (i + 1 < raw_len) ? raw_data[i + 1] : 0;
-        uint8_t byte2 = (i + 2 < raw_len) ? raw_data[i + 2] : 0;
+// 64 chars -> 48 bytes; stores nothing and returns false on a bad char or '='
+static FORCE_INLINE bool base64_decode_neon(const char *in, uint8_t *out, const uint8x16x4_t *lo, const uint8x16x4_t *hi) {
+    uint8x16x4_t c = vld4q_u8((const uint8_t *)in);
+    uint8x16_t bad = vdupq_n_u8(0);
+    uint8x16x3_t b;
 
-        uint32_t buf24 = (byte0 << 16) | (byte1 << 8) | byte2;
-        size_t remaining = raw_len - i;
+    for (int k = 0; k < 4; k++) c.val[k] = neon_lookup128(lo, hi, c.val[k], &bad);
+    if (neon_any_bad(bad)) return false;
 
-        out_encoded[out_index++] = enc_table[(buf24 >> 18) & 0x3F];
-        out_encoded[out_index++] = enc_table[(buf24 >> 12) & 0x3F];
+    b.val[0] = vorrq_u8(vshlq_n_u8(c.val[0], 2), vshrq_n_u8(c.val[1], 4));
+    b.val[1] = vorrq_u8(vshlq_n_u8(c.val[1], 4), vshrq_n_u8(c.val[2], 2));
+    b.val[2] = vorrq_u8(vshlq_n_u8(c.val[2], 6), c.val[3]);
+    vst3q_u8(out, b);
+    return true;
+}
+
+#endif // TINY_CBASE_NEON
+
+// WHATWG "ASCII whitespace": TAB, LF, FF, CR and SPACE (no VT)
+static FORCE_INLINE bool base64_is_html_space(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\f' || c == '\r';
+}
+
+#if TINY_CBASE_SSE2
+
+// Maps 16 chars to their 6-bit values with range compares and adds (no table
+// lookups). `valid` gets 0xFF for every char of the selected alphabet.
+static FORCE_INLINE __m128i base64_translate_sse2(__m128i v, bool url_safe, __m128i *valid) {
+    __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    __m128i lower = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('z' + 1)));
+    __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+    __m128i c62 = _mm_cmpeq_epi8(v, _mm_set1_epi8(url_safe ? '-' : '+'));
+    __m128i c63 = _mm_cmpeq_epi8(v, _mm_set1_epi8(url_safe ? '_' : '/'));
+
+    __m128i shift = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+    shift = _mm_or_si128(shift, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+    shift = _mm_or_si128(shift, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+    shift = _mm_or_si128(shift, _mm_and_si128(c62, _mm_set1_epi8((char)(62 - (url_safe ? '-' : '+')))));
+    shift = _mm_or_si128(shift, _mm_and_si128(c63, _mm_set1_epi8((char)(63 - (url_safe ? '_' : '/')))));
+
+    *valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(c62, c63)));
+    return _mm_add_epi8(v, shift);
+}
+
+// Packs 16 sextets into 12 bytes: pairs are merged in 16-bit lanes, then in
+// 32-bit lanes, leaving one 24-bit quantum per lane. Writes exactly 12 bytes.
+static FORCE_INLINE void base64_pack_sse2(__m128i sextets, uint8_t *out) {
+    __m128i t = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(sextets, _mm_set1_epi16(0x00FF)), 6), _mm_srli_epi16(sextets, 8));
+    __m128i u = _mm_or_si128(_mm_slli_epi32(_mm_and_si128(t, _mm_set1_epi32(0xFFFF)), 12), _mm_srli_epi32(t, 16));
+
+    uint32_t q[4];
+    _mm_storeu_si128((__m128i *)q, u);
+    for (int k = 0; k < 4; k++) {
+        out[k * 3 + 0] = (uint8_t)(q[k] >> 16);
+        out[k * 3 + 1] = (uint8_t)(q[k] >> 8);
+        out[k * 3 + 2] = (uint8_t)q[k];
+    }
+}
+
+#endif // TINY_CBASE_SSE2
+
+// Constant-time mapping (BASE_CONST_TIME), scalar parts.
+static FORCE_INLINE char base64_ct_char(uint32_t s, bool url_safe) {
+    uint32_t c = s + 'A';
+    c += ct_ge(s, 26) & 6;                          // 'a'..'z'
+    c -= ct_ge(s, 52) & 75;                         // '0'..'9'
+    c -= ct_ge(s, 62) & (url_safe ? 13u : 15u);     // '-' or '+'
+    c += ct_eq(s, 63) & (url_safe ? 49u : 3u);      // '_' or '/'
+    return (char)c;
+}
+
+// Returns the 6-bit value of c; *invalid collects all-ones for chars outside the alphabet.
+static FORCE_INLINE uint32_t base64_ct_value(uint32_t c, bool url_safe, uint32_t *invalid) {
+    uint32_t upper = ct_ge(c, 'A') & ct_lt(c, 'Z' + 1);
+    uint32_t lower = ct_ge(c, 'a') & ct_lt(c, 'z' + 1);
+    uint32_t digit = ct_ge(c, '0') & ct_lt(c, '9' + 1);
+    uint32_t c62 = ct_eq(c, url_safe ? '-' : '+');
+    uint32_t c63 = ct_eq(c, url_safe ? '_' : '/');
+
+    *invalid |= ~(upper | lower | digit | c62 | c63);
+    return (upper & (c - 'A')) | (lower & (c - 'a' + 26)) | (digit & (c - '0' + 52)) | (c62 & 62) | (c63 & 63);
+}
+
+#if TINY_CBASE_SSE2
+
+// 12 bytes -> 16 chars without table lookups: the 24-bit quanta are split
+// into one sextet per byte lane, then mapped with compares and adds.
+static FORCE_INLINE void base64_encode_ct_sse2(const uint8_t *in, char *out, bool url_safe) {
+    uint32_t q[4];
+    for (int k = 0; k < 4; k++) {
+        q[k] = ((uint32_t)in[k * 3] << 16) | ((uint32_t)in[k * 3 + 1] << 8) | in[k * 3 + 2];
+    }
+
+    __m128i u = _mm_loadu_si128((const __m128i *)q);
+    __m128i s = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(u, 18), _mm_set1_epi32(0x3F)),
+                                          _mm_and_si128(_mm_srli_epi32(u, 4), _mm_set1_epi32(0x3F00))),
+                             _mm_or_si128(_mm_and_si128(_mm_slli_epi32(u, 10), _mm_set1_epi32(0x3F0000)),
+                                          _mm_and_si128(_mm_slli_epi32(u, 24), _mm_set1_epi32(0x3F000000))));
+
+    __m128i c = _mm_add_epi8(s, _mm_set1_epi8('A'));
+    c = _mm_add_epi8(c, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(25)), _mm_set1_epi8(6)));
+    c = _mm_sub_epi8(c, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(51)), _mm_set1_epi8(75)));
+    c = _mm_sub_epi8(c, _mm_and_si128(_mm_cmpgt_epi8(s, _mm_set1_epi8(61)), _mm_set1_epi8(url_safe ? 13 : 15)));
+    c = _mm_add_epi8(c, _mm_and_si128(_mm_cmpeq_epi8(s, _mm_set1_epi8(63)), _mm_set1_epi8(url_safe ? 49 : 3)));
+
+    _mm_storeu_si128((__m128i *)out, c);
+}
+
+#endif // TINY_CBASE_SSE2
+
+static bool base64_encode_ct(const uint8_t *raw_data, size_t raw_len, char *out_encoded, size_t *out_encoded_len, bool url_safe, bool no_pad) {
+    size_t i = 0;
+    size_t out_index = 0;
+
+#if TINY_CBASE_SSE2
+    for (; raw_len - i >= 12; i += 12, out_index += 16) {
+        base_prefetch(raw_data, i, raw_len, 12);
+        base64_encode_ct_sse2(raw_data + i, out_encoded + out_index, url_safe);
+    }
+#endif
+
+    for (; raw_len - i >= 3; i += 3) {
+        uint32_t buf24 = ((uint32_t)raw_data[i] << 16) | ((uint32_t)raw_data[i + 1] << 8) | raw_data[i + 2];
+        out_encoded[out_index++] = base64_ct_char(buf24 >> 18, url_safe);
+        out_encoded[out_index++] = base64_ct_char((buf24 >> 12) & 0x3F, url_safe);
+        out_encoded[out_index++] = base64_ct_char((buf24 >> 6) & 0x3F, url_safe);
+        out_encoded[out_index++] = base64_ct_char(buf24 & 0x3F, url_safe);
+    }
+
+    // The tail length is public: it only depends on raw_len
+    size_t remaining = raw_len - i;
+    if (remaining) {
+        uint32_t buf24 = ((uint32_t)raw_data[i] << 16) | ((remaining > 1) ? ((uint32_t)raw_data[i + 1] << 8) : 0);
+        out_encoded[out_index++] = base64_ct_char(buf24 >> 18, url_safe);
+        out_encoded[out_index++] = base64_ct_char((buf24 >> 12) & 0x3F, url_safe);
+
+        if (remaining > 1) out_encoded[out_index++] = base64_ct_char((buf24 >> 6) & 0x3F, url_safe);
+        else if (!no_pad) out_encoded[out_index++] = BASE64_PAD_CHAR;
+
+        if (!no_pad) out_encoded[out_index++] = BASE64_PAD_CHAR;
+    }
+
+    out_encoded[out_index] = '\0';
+    *out_encoded_len = out_index;
+    return true;
+}
+
+// First char that is not in the alphabet, ignoring trailing '=' (which the
+// constant-time decoder strips before mapping). Failure path only.
+static size_t base64_find_invalid(const char *encoded_data, size_t encoded_len, bool url_safe) {
+    const char start_char = url_safe ? BASE64_URL_SAFE_MIN : BASE64_MIN;
+    const int8_t *rev_table = url_safe ? BASE64_REV_URL_SAFE_TABLE : BASE64_REV_TABLE;
+    size_t i = 0;
+    while (i < encoded_len) {
+        char c = encoded_data[i];
+        if (c < start_char || c > BASE64_MAX || rev_table[c - start_char] < 0) break;
+        i++;
+    }
+    return i;
+}
+
+static bool base64_decode_ct(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, bool url_safe, bool no_pad, BASE_Error *err) {
+    if (!no_pad && encoded_len % 4 != 0) return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, encoded_len);
+
+    // Trailing '=' only reveal the decoded length, which is public anyway
+    size_t n = encoded_len;
+    if (n && encoded_data[n - 1] == BASE64_PAD_CHAR) n--;
+    if (n && encoded_data[n - 1] == BASE64_PAD_CHAR) n--;
+    if (n % 4 == 1) return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, encoded_len);
+
+    size_t i = 0;
+    size_t out_index = 0;
+    uint32_t invalid = 0;
+
+#if TINY_CBASE_SSE2
+    __m128i bad = _mm_setzero_si128();
+    for (; n - i >= 16; i += 16, out_index += 12) {
+        base_prefetch(encoded_data, i, n, 16);
+        __m128i valid;
+        __m128i v = base64_translate_sse2(_mm_loadu_si128((const __m128i *)(encoded_data + i)), url_safe, &valid);
+        bad = _mm_or_si128(bad, _mm_andnot_si128(valid, _mm_set1_epi8(-1)));
+        base64_pack_sse2(v, out_decoded + out_index);
+    }
+    invalid |= (uint32_t)_mm_movemask_epi8(bad);
+#endif
+
+    for (; n - i >= 4; i += 4) {
+        uint32_t buf24 = 0;
+        for (int j = 0; j < 4; j++) {
+            buf24 = (buf24 << 6) | base64_ct_value((unsigned char)encoded_data[i + (size_t)j], url_safe, &invalid);
+        }
+        out_decoded[out_index++] = (uint8_t)(buf24 >> 16);
+        out_decoded[out_index++] = (uint8_t)(buf24 >> 8);
+        out_decoded[out_index++] = (uint8_t)buf24;
+    }
+
+    size_t remaining = n - i;
+    if (remaining) {
+        uint32_t buf24 = 0;
+        for (size_t j = 0; j < remaining; j++) {
+            buf24 |= base64_ct_value((unsigned char)encoded_data[i + j], url_safe, &invalid) << (18 - j * 6);
+        }
+        out_decoded[out_index++] = (uint8_t)(buf24 >> 16);
+        if (remaining > 2) out_decoded[out_index++] = (uint8_t)(buf24 >> 8);
+    }
+
+    // Single check at the end, no early exit on the first bad char
+    if (invalid) {
+        size_t bad = base64_find_invalid(encoded_data, n, url_safe);
+        return base_fail(err, encoded_data[bad] == BASE64_PAD_CHAR ? BASE_ERR_BAD_PADDING : BASE_ERR_INVALID_CHAR, encoded_data, bad);
+    }
+
+    *out_decoded_len = out_index;
+    return true;
+}
+
+static bool base64_decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags, BASE_Error *err);
+
+static bool base64_encode_chunk(const uint8_t *in, size_t in_len, uint8_t *out, size_t *out_len, int mode_flags, BASE_Error *err) {
+    (void)err;
+    return BASE64_Encode(in, in_len, (char *)out, out_len, mode_flags);
+}
+
+static bool base64_decode_chunk(const uint8_t *in, size_t in_len, uint8_t *out, size_t *out_len, int mode_flags, BASE_Error *err) {
+    return base64_decode((const char *)in, in_len, out, out_len, mode_flags, err);
+}
+
+bool BASE64_Encode(const uint8_t *raw_data, size_t raw_len, char *out_encoded, size_t *out_encoded_len, int mode_flags) {
+    if (!raw_data || raw_len == 0 || !out_encoded || !out_encoded_len) return false;
+
+#if TINY_CBASE_STREAM
+    if (base_stream_wanted(raw_len / 3 * 4)) {
+        return base_stream_run(base64_encode_chunk, raw_data, raw_len, (uint8_t *)out_encoded, out_encoded_len, mode_flags, NULL, 3, 4);
+    }
+#endif
+
+    bool url_safe = (mode_flags & BASE64_URL_ENC) != 0;
+    bool no_pad   = (mode_flags & BASE64_NOPAD_ENC) != 0;
+
+    if (mode_flags & BASE_CONST_TIME) {
+        return base64_encode_ct(raw_data, raw_len, out_encoded, out_encoded_len, url_safe, no_pad);
+    }
+
+    const char *enc_table = url_safe ? BASE64_URL_SAFE_TABLE : BASE64_ENC_TABLE;
+    size_t out_index = 0;
+    size_t i = 0;
+
+#if TINY_CBASE_NEON
+    if (base_neon_available()) {
+        const uint8x16x4_t t = neon_load_table4((const uint8_t *)enc_table);
+        for (; raw_len - i >= 48; i += 48) {
+            base_prefetch(raw_data, i, raw_len, 48);
+            base64_encode_neon(raw_data + i, out_encoded + i / 3 * 4, &t);
+        }
+        out_index = i / 3 * 4;
+    }
+#endif
+
+    for (; i < raw_len; i += 3) {
+        uint8_t byte0 = raw_data[i];
+        uint8_t byte1 = (i + 1 < raw_len) ? raw_data[i + 1] : 0;
+        uint8_t byte2 = (i + 2 < raw_len) ? raw_data[i + 2] : 0;
+
+        uint32_t buf24 = (byte0 << 16) | (byte1 << 8) | byte2;
+        size_t remaining = raw_len - i;
+
+        out_encoded[out_index++] = enc_table[(buf24 >> 18) & 0x3F];
+        out_encoded[out_index++] = enc_table[(buf24 >> 12) & 0x3F];
 
         if (remaining > 1) out_encoded[out_index++] = enc_table[(buf24 >> 6) & 0x3F];
         else if (!no_pad) out_encoded[out_index++] = BASE64_PAD_CHAR;
@@ -395,8 +1383,121 @@ bool BASE64_Encode(const uint8_t *raw_data, size_t raw_len, char *out_encoded, s
     return true;
 }
 
-bool BASE64_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags) {
-    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len) return false;
+// WHATWG forgiving-base64 decode (atob): ASCII whitespace anywhere is ignored,
+// '=' padding is optional but, when present, must complete the last quantum,
+// and a single leftover char is an error. As in the spec (and browsers), the
+// unused low bits of the last quantum are discarded.
+// The vector loop classifies 16 chars per step and compacts away whitespace
+// itself, so there is no separate clean-up pass.
+static bool base64_decode_forgiving(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, bool url_safe, BASE_Error *err) {
+    const char start_char = url_safe ? BASE64_URL_SAFE_MIN : BASE64_MIN;
+    const int8_t *rev_table = url_safe ? BASE64_REV_URL_SAFE_TABLE : BASE64_REV_TABLE;
+
+    size_t index = 0;
+    size_t i = 0;
+    uint32_t acc = 0;   // pending sextets of the current quantum
+    int nacc = 0;
+
+#if TINY_CBASE_SSE2
+    uint8_t st[32]; // staged sextets (< 16 carried over + one block)
+    size_t ns = 0;
+
+    while (encoded_len - i >= 16) {
+        __m128i valid;
+        base_prefetch(encoded_data, i, encoded_len, 16);
+        __m128i raw = _mm_loadu_si128((const __m128i *)(encoded_data + i));
+        __m128i v = base64_translate_sse2(raw, url_safe, &valid);
+        __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(raw, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(raw, _mm_set1_epi8('\t'))),
+                                  _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(raw, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(raw, _mm_set1_epi8('\r'))),
+                                               _mm_cmpeq_epi8(raw, _mm_set1_epi8('\f'))));
+
+        uint32_t vmask = (uint32_t)_mm_movemask_epi8(valid);
+        uint32_t handled = vmask | (uint32_t)_mm_movemask_epi8(ws);
+
+        if (vmask == 0xFFFF && ns == 0) {
+            base64_pack_sse2(v, out_decoded + index);
+            index += 12;
+        } else if (vmask == 0xFFFF) {
+            _mm_storeu_si128((__m128i *)(st + ns), v);
+            ns += 16;
+        } else {
+            // Compact: keep the sextets of valid chars up to the first char
+            // the vector loop does not handle ('=' or invalid)
+            uint8_t tmp[16];
+            size_t limit = (handled == 0xFFFF) ? 16 : base_ctz32(~handled);
+
+            _mm_storeu_si128((__m128i *)tmp, v);
+            for (uint32_t m = vmask & ((1u << limit) - 1); m; m &= m - 1) st[ns++] = tmp[base_ctz32(m)];
+
+            if (limit < 16) {
+                i += limit;
+                break;
+            }
+        }
+
+        if (ns >= 16) {
+            base64_pack_sse2(_mm_loadu_si128((const __m128i *)st), out_decoded + index);
+            index += 12;
+            ns -= 16;
+            memmove(st, st + 16, ns);
+        }
+        i += 16;
+    }
+
+    for (size_t j = 0; j < ns; j++) {
+        acc = (acc << 6) | st[j];
+        if (++nacc == 4) {
+            out_decoded[index++] = (uint8_t)(acc >> 16);
+            out_decoded[index++] = (uint8_t)(acc >> 8);
+            out_decoded[index++] = (uint8_t)acc;
+            acc = 0;
+            nacc = 0;
+        }
+    }
+#endif // TINY_CBASE_SSE2
+
+    int pads = 0;
+    size_t first_pad = 0;
+    for (; i < encoded_len; i++) {
+        char c = encoded_data[i];
+        if (base64_is_html_space(c)) continue;
+
+        if (c == BASE64_PAD_CHAR) {
+            if (pads++ == 0) first_pad = i;
+            continue;
+        }
+        if (pads) return base_fail(err, BASE_ERR_BAD_PADDING, encoded_data, first_pad); // data after padding
+
+        int8_t val = (c >= start_char && c <= BASE64_MAX) ? rev_table[c - start_char] : -1;
+        if (val < 0) return base_fail(err, BASE_ERR_INVALID_CHAR, encoded_data, i);
+
+        acc = (acc << 6) | (uint32_t)val;
+        if (++nacc == 4) {
+            out_decoded[index++] = (uint8_t)(acc >> 16);
+            out_decoded[index++] = (uint8_t)(acc >> 8);
+            out_decoded[index++] = (uint8_t)acc;
+            acc = 0;
+            nacc = 0;
+        }
+    }
+
+    // Padding, if any, must complete a 2- or 3-char quantum to 4
+    if (nacc == 1) return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, encoded_len);
+    if (pads && (nacc < 2 || nacc + pads != 4)) return base_fail(err, BASE_ERR_BAD_PADDING, encoded_data, first_pad);
+
+    if (nacc == 2) {
+        out_decoded[index++] = (uint8_t)(acc >> 4);
+    } else if (nacc == 3) {
+        out_decoded[index++] = (uint8_t)(acc >> 10);
+        out_decoded[index++] = (uint8_t)(acc >> 2);
+    }
+
+    *out_decoded_len = index;
+    return true;
+}
+
+static bool base64_decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags, BASE_Error *err) {
+    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len) return base_fail(err, BASE_ERR_ARGS, NULL, 0);
 
 #if BASE_TRUNCATE_ON_NULL
     // Adjust encoded_len if null terminator appears before
@@ -412,24 +1513,54 @@ bool BASE64_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
     bool isUrlSafe = (mode_flags & BASE64_URL_DEC) != 0;
     bool noPad = (mode_flags & BASE64_NOPAD_DEC) != 0;
 
+    if (mode_flags & BASE64_FORGIVING_DEC) {
+        return base64_decode_forgiving(encoded_data, encoded_len, out_decoded, out_decoded_len, isUrlSafe, err);
+    }
+    if (mode_flags & BASE_CONST_TIME) {
+        return base64_decode_ct(encoded_data, encoded_len, out_decoded, out_decoded_len, isUrlSafe, noPad, err);
+    }
+
     // Only check padding rules if standard Base64 or URL-safe with padding
     if ((isStd || isUrlSafe) && !noPad && (encoded_len % 4 != 0)) {
-        return false; // invalid length
+        return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, encoded_len);
+    }
+
+#if TINY_CBASE_STREAM
+    // Strict mode only: '=' is judged per quantum there. The forgiving and
+    // constant-time decoders check padding across the whole input.
+    if (base_stream_wanted(encoded_len / 4 * 3)) {
+        return base_stream_run(base64_decode_chunk, (const uint8_t *)encoded_data, encoded_len, out_decoded, out_decoded_len, mode_flags, err, 4, 3);
     }
+#endif
 
     const char start_char = isUrlSafe ? BASE64_URL_SAFE_MIN : BASE64_MIN;
     const int8_t *rev_table = isUrlSafe ? BASE64_REV_URL_SAFE_TABLE : BASE64_REV_TABLE;
 
     size_t out_index = 0;
+    size_t i = 0;
+
+#if TINY_CBASE_NEON
+    // Padding or a bad char ends the vector loop; the scalar loop takes over there
+    if (base_neon_available()) {
+        const uint8_t *neon_rev = isUrlSafe ? BASE64_NEON_REV_URL_SAFE_TABLE : BASE64_NEON_REV_TABLE;
+        const uint8x16x4_t lo = neon_load_table4(neon_rev);
+        const uint8x16x4_t hi = neon_load_table4(neon_rev + 64);
+        for (; encoded_len - i >= 64; i += 64) {
+            base_prefetch(encoded_data, i, encoded_len, 64);
+            if (!base64_decode_neon(encoded_data + i, out_decoded + i / 4 * 3, &lo, &hi)) break;
+        }
+        out_index = i / 4 * 3;
+    }
+#endif
 
-    for (size_t i = 0; i < encoded_len; i += 4) {
+    for (; i < encoded_len; i += 4) {
         uint32_t buf24 = 0;
         int valid_chars = 0;
 
         for (int j = 0; j < 4; ++j) {
             char c = (i + j < encoded_len) ? encoded_data[i + j] : BASE64_PAD_CHAR;
             int8_t val = (c == BASE64_PAD_CHAR) ? 0 : ((c >= start_char && c <= BASE64_MAX) ? rev_table[c - start_char] : -1);
-            if (val < 0) return false;
+            if (val < 0) return base_fail(err, BASE_ERR_INVALID_CHAR, encoded_data, i + (size_t)j);
 
             buf24 |= ((uint32_t)val << (18 - j * 6));
             if (c != BASE64_PAD_CHAR) valid_chars++;
@@ -444,6 +1575,279 @@ bool BASE64_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
     return true;
 }
 
+bool BASE64_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags) {
+    return base64_decode(encoded_data, encoded_len, out_decoded, out_decoded_len, mode_flags, NULL);
+}
+
+// // --- JSON string tokens ---
+#define BASE64_JSON_QUOTE '"'
+#define BASE64_JSON_CHUNK 256 // staged chars per decode call, a multiple of 4
+
+bool BASE64_EncodeJson(const uint8_t *raw_data, size_t raw_len, char *out_json, size_t *out_json_len, int mode_flags) {
+    if (!raw_data || raw_len == 0 || !out_json || !out_json_len) return false;
+
+    // The Base64 alphabets never need escaping in JSON, so the body is written
+    // in place between the quotes
+    size_t body_len;
+    out_json[0] = BASE64_JSON_QUOTE;
+    if (!BASE64_Encode(raw_data, raw_len, out_json + 1, &body_len, mode_flags)) return false;
+
+    out_json[body_len + 1] = BASE64_JSON_QUOTE;
+    out_json[body_len + 2] = '\0';
+    *out_json_len = body_len + 2;
+    return true;
+}
+
+static int base64_hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Unescapes a JSON string body (esc = '\\') or a URL-encoded data: URI body
+// (esc = '%') and decodes it chunk by chunk, so escapes cost one copy into a
+// small stack buffer instead of a separately unescaped string.
+static bool base64_decode_escaped(const char *body, size_t body_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags, char esc) {
+    bool forgiving = (mode_flags & BASE64_FORGIVING_DEC) != 0;
+    bool pad_at_end_only = forgiving || (mode_flags & BASE_CONST_TIME) != 0;
+    char chunk[BASE64_JSON_CHUNK + 4];
+    size_t staged = 0;
+    size_t index = 0;
+    int pads = 0;
+
+    for (size_t i = 0; i < body_len; i++) {
+        char c = body[i];
+
+        if (c == '%' && esc == '%') {
+            if (body_len - i < 3) return false;
+            int hi = base64_hex_digit(body[i + 1]), lo = base64_hex_digit(body[i + 2]);
+            if (hi < 0 || lo < 0 || hi > 7) return false; // never part of a Base64 alphabet
+            c = (char)(hi << 4 | lo);
+            i += 2;
+        } else if (c == '\\' && esc == '\\') {
+            if (++i >= body_len) return false;
+            switch (body[i]) {
+                case '"':  c = '"';  break;
+                case '\\': c = '\\'; break;
+                case '/':  c = '/';  break;
+                case 'b':  c = '\b'; break;
+                case 'f':  c = '\f'; break;
+                case 'n':  c = '\n'; break;
+                case 'r':  c = '\r'; break;
+                case 't':  c = '\t'; break;
+                case 'u': {
+                    if (body_len - i < 5) return false;
+                    int code = 0;
+                    for (int j = 1; j <= 4; j++) {
+                        int h = base64_hex_digit(body[i + (size_t)j]);
+                        if (h < 0) return false;
+                        code = (code << 4) | h;
+                    }
+                    if (code > 0x7F) return false; // never part of a Base64 alphabet
+                    c = (char)code;
+                    i += 4;
+                    break;
+                }
+                default: return false;
+            }
+        }
+
+        // Whitespace never reaches the forgiving decoder, so staged chars are
+        // whole quanta at each flush. Forgiving and constant-time decoding only
+        // accept '=' at the very end, so no flush once padding has started.
+        if (forgiving && base64_is_html_space(c)) continue;
+        if (pad_at_end_only) {
+            if (c == BASE64_PAD_CHAR) {
+                if (++pads > 2) return false;
+            } else if (pads) {
+                return false;
+            }
+        }
+
+        chunk[staged++] = c;
+        if (staged >= BASE64_JSON_CHUNK && pads == 0) {
+            size_t n;
+            if (!BASE64_Decode(chunk, staged, out_decoded + index, &n, mode_flags)) return false;
+            index += n;
+            staged = 0;
+        }
+    }
+
+    if (staged) {
+        size_t n;
+        if (!BASE64_Decode(chunk, staged, out_decoded + index, &n, mode_flags)) return false;
+        index += n;
+    } else if (index == 0) {
+        return false; // empty string
+    }
+
+    *out_decoded_len = index;
+    return true;
+}
+
+bool BASE64_DecodeJson(const char *json, size_t json_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags) {
+    if (!json || json_len < 2 || !out_decoded || !out_decoded_len) return false;
+    if (json[0] != BASE64_JSON_QUOTE || json[json_len - 1] != BASE64_JSON_QUOTE) return false;
+
+    const char *body = json + 1;
+    size_t body_len = json_len - 2;
+
+    // Common case: nothing escaped, decode the token in place
+    if (!memchr(body, '\\', body_len)) {
+        return BASE64_Decode(body, body_len, out_decoded, out_decoded_len, mode_flags);
+    }
+    return base64_decode_escaped(body, body_len, out_decoded, out_decoded_len, mode_flags, '\\');
+}
+
+// // --- Data URIs (RFC 2397) ---
+#define BASE64_DATA_URI_SCHEME "data:"
+#define BASE64_DATA_URI_MARKER ";base64,"
+
+bool BASE64_EncodeDataUri(const char *mime, const uint8_t *raw_data, size_t raw_len, char *out_uri, size_t *out_uri_len) {
+    if (!raw_data || raw_len == 0 || !out_uri || !out_uri_len) return false;
+
+    size_t mime_len = mime ? strlen(mime) : 0; // empty mediatype means text/plain
+    size_t index = sizeof(BASE64_DATA_URI_SCHEME) - 1;
+
+    memcpy(out_uri, BASE64_DATA_URI_SCHEME, index);
+    if (mime_len) memcpy(out_uri + index, mime, mime_len);
+    index += mime_len;
+    memcpy(out_uri + index, BASE64_DATA_URI_MARKER, sizeof(BASE64_DATA_URI_MARKER) - 1);
+    index += sizeof(BASE64_DATA_URI_MARKER) - 1;
+
+    size_t body_len;
+    if (!BASE64_Encode(raw_data, raw_len, out_uri + index, &body_len, BASE64_STD_ENC)) return false;
+
+    *out_uri_len = index + body_len;
+    return true;
+}
+
+static bool base64_ascii_ieq(const char *s, size_t len, const char *lit) {
+    for (size_t i = 0; i < len; i++) {
+        if (!lit[i] || tolower((unsigned char)s[i]) != lit[i]) return false;
+    }
+    return lit[len] == '\0';
+}
+
+bool BASE64_ParseDataUri(const char *uri, size_t uri_len, BASE64_DataUri *out_view) {
+    if (!uri || !out_view) return false;
+
+    const size_t scheme_len = sizeof(BASE64_DATA_URI_SCHEME) - 1;
+    if (uri_len < scheme_len || !base64_ascii_ieq(uri, scheme_len, BASE64_DATA_URI_SCHEME)) return false;
+
+    const char *comma = (const char *)memchr(uri + scheme_len, ',', uri_len - scheme_len);
+    if (!comma) return false;
+
+    const char *meta = uri + scheme_len;
+    size_t meta_len = (size_t)(comma - meta);
+
+    // mediatype is everything up to the first ';'
+    const char *semi = (const char *)memchr(meta, ';', meta_len);
+    size_t mime_len = semi ? (size_t)(semi - meta) : meta_len;
+
+    out_view->mime = meta;
+    out_view->mime_len = mime_len;
+    out_view->params = meta + mime_len;
+    out_view->params_len = meta_len - mime_len;
+    out_view->body = comma + 1;
+    out_view->body_len = uri_len - (size_t)(comma + 1 - uri);
+
+    // ";base64" must be the last parameter
+    const size_t b64_len = sizeof(";base64") - 1;
+    out_view->is_base64 = out_view->params_len >= b64_len &&
+                          base64_ascii_ieq(meta + meta_len - b64_len, b64_len, ";base64");
+    if (out_view->is_base64) out_view->params_len -= b64_len;
+
+    return true;
+}
+
+bool BASE64_DecodeDataUri(const char *uri, size_t uri_len, uint8_t *arena, size_t arena_len, BASE64_DataUri *out_view, size_t *out_decoded_len) {
+    if (!arena || !out_decoded_len) return false;
+    if (!BASE64_ParseDataUri(uri, uri_len, out_view) || !out_view->is_base64) return false;
+
+    // Largest output the decoder can write for this body
+    if (arena_len < (out_view->body_len + 3) / 4 * 3) return false;
+
+    // Browsers decode data: bodies with forgiving-base64, so do the same. The
+    // body is URL-encoded ("%3D" for '='), escapes only shrink it.
+    const int flags = BASE64_STD_DEC | BASE64_FORGIVING_DEC;
+    if (!memchr(out_view->body, '%', out_view->body_len)) {
+        return BASE64_Decode(out_view->body, out_view->body_len, arena, out_decoded_len, flags);
+    }
+    return base64_decode_escaped(out_view->body, out_view->body_len, arena, out_decoded_len, flags, '%');
+}
+
+// // --- JWT (RFC 7519 compact serialization) ---
+#define BASE64_JWT_DOT '.'
+
+// Offset of the first '.' or '=' at or after from, or len if there is none.
+// base64url in JWS has no padding (RFC 7515), so the same pass that finds the
+// dots also finds any '=', which the strict decoder would take for padding.
+static size_t base64_jwt_find_stop(const char *token, size_t from, size_t len) {
+    size_t i = from;
+#if TINY_CBASE_SSE2
+    const __m128i dot = _mm_set1_epi8(BASE64_JWT_DOT);
+    const __m128i pad = _mm_set1_epi8(BASE64_PAD_CHAR);
+    for (; len - i >= 16; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(token + i));
+        uint32_t m = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, dot), _mm_cmpeq_epi8(v, pad)));
+        if (m) return i + base_ctz32(m);
+    }
+#endif
+    for (; i < len; i++) {
+        if (token[i] == BASE64_JWT_DOT || token[i] == BASE64_PAD_CHAR) break;
+    }
+    return i;
+}
+
+static bool base64_jwt_segment(const char *seg, size_t seg_len, uint8_t *out, size_t *out_len) {
+    // Empty payload (detached) and signature ("alg": "none") are allowed
+    if (seg_len == 0) {
+        *out_len = 0;
+        return true;
+    }
+    if (seg_len % 4 == 1) return false;
+    return BASE64_Decode(seg, seg_len, out, out_len, BASE64_URL_DEC | BASE64_NOPAD_DEC);
+}
+
+bool BASE64_DecodeJwt(const char *token, size_t token_len, uint8_t *arena, size_t arena_len, BASE64_Jwt *out_parts, size_t *out_decoded_len) {
+    if (!token || !arena || !out_parts || !out_decoded_len) return false;
+
+    size_t dot1 = base64_jwt_find_stop(token, 0, token_len);
+    if (dot1 == 0 || dot1 >= token_len || token[dot1] != BASE64_JWT_DOT) return false;
+    size_t dot2 = base64_jwt_find_stop(token, dot1 + 1, token_len);
+    if (dot2 >= token_len || token[dot2] != BASE64_JWT_DOT) return false;
+
+    // No '=' in the signature either, and no third dot (JWE has five segments)
+    if (base64_jwt_find_stop(token, dot2 + 1, token_len) != token_len) return false;
+
+    // One bound for all three segments: unpadded base64url decodes to at most
+    // 3/4 of its length, and the two dots are not decoded
+    if (arena_len < BASE64_JWT_DEC_LEN(token_len)) return false;
+
+    size_t len;
+    size_t index = 0;
+
+    if (!base64_jwt_segment(token, dot1, arena, &len)) return false;
+    out_parts->header_off = index;
+    out_parts->header_len = len;
+    index += len;
+
+    if (!base64_jwt_segment(token + dot1 + 1, dot2 - dot1 - 1, arena + index, &len)) return false;
+    out_parts->payload_off = index;
+    out_parts->payload_len = len;
+    index += len;
+
+    if (!base64_jwt_segment(token + dot2 + 1, token_len - dot2 - 1, arena + index, &len)) return false;
+    out_parts->signature_off = index;
+    out_parts->signature_len = len;
+    index += len;
+
+    *out_decoded_len = index;
+    return true;
+}
+
 #endif // TINY_CBASE_ENABLE_BASE64
 
 #if TINY_CBASE_ENABLE_BASE85
@@ -491,6 +1895,29 @@ static const int8_t BASE85_Z85_REV_TABLE[] = {
     79, -1, 80  // '{', '}', offsets 90-92
 };
 
+// RFC 1924 alphabet (128-bit values, IPv6 addresses)
+static const char BASE85_RFC1924_ENC_TABLE[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz!#$%&()*+-;<=>?@^_`{|}~";
+
+#define BASE85_RFC1924_MIN '!'
+#define BASE85_RFC1924_MAX '~'
+
+// 85^4: the 128-bit value is processed as five 4-digit chunks
+#define RFC1924_CHUNK 52200625u
+
+// Base85 reverse lookup table (RFC 1924).
+// This table maps ASCII characters '!' (33) to '~' (126) into RFC 1924 values.
+// Indexing: val = BASE85_RFC1924_REV_TABLE[ch - '!']
+// - Valid chars map to 0..84
+// - Invalid chars are -1
+static const int8_t BASE85_RFC1924_REV_TABLE[] = {
+    62, -1, 63, 64, 65, 66, -1, 67, 68, 69, 70, -1, 71, -1, -1,  0, // '!' to '0'
+     1,  2,  3,  4,  5,  6,  7,  8,  9, -1, 72, 73, 74, 75, 76, 77, // '1' to '@'
+    10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, // 'A' to 'P'
+    26, 27, 28, 29, 30, 31, 32, 33, 34, 35, -1, -1, -1, 78, 79, 80, // 'Q' to '`'
+    36, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, // 'a' to 'p'
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 81, 82, 83, 84          // 'q' to '~'
+};
+
 static FORCE_INLINE void write_u32_be(uint8_t *out_decoded, uint32_t value) {
     // Manual big-endian
     out_decoded[0] = (uint8_t)((value >> 24) & 0xFF);
@@ -503,75 +1930,588 @@ static FORCE_INLINE uint32_t read_u32_be(const uint8_t *in) {
     return ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
 }
 
-// --- Encode Base85 / Z85 ---
-bool BASE85_Encode(const uint8_t *encoded_data, size_t encoded_len, char *out_decoded, size_t *out_decoded_len, int mode_flags) {
-    if (!encoded_data || !out_decoded || !out_decoded_len) return false;
+#define ASCII85_FRAME_START "<~"
+#define ASCII85_FRAME_END   "~>"
+#define BTOA_HEADER         "xbtoa Begin"
+#define BTOA_TRAILER        "xbtoa End"
+
+// btoa running checksums (xor, sum and rotate). Like the original btoa/atob
+// they cover every byte of every group, zero padding of the last group included.
+typedef struct {
+    uint32_t eor;
+    uint32_t sum;
+    uint32_t rot;
+} btoa_checksum_t;
+
+// Values parsed from "xbtoa End N <dec> <hex> E <hex> S <hex> R <hex>"
+typedef struct {
+    uint64_t n;
+    uint64_t n_hex;
+    uint64_t eor;
+    uint64_t sum;
+    uint64_t rot;
+} btoa_trailer_t;
+
+static FORCE_INLINE void btoa_checksum_update(btoa_checksum_t *ck, uint32_t word) {
+    for (int j = 24; j >= 0; j -= 8) {
+        uint32_t c = (word >> j) & 0xFF;
+        ck->eor ^= c;
+        ck->sum += c + 1;
+        ck->rot = ((ck->rot << 1) | (ck->rot >> 31)) + c;
+    }
+}
 
-    bool isZ85 = (mode_flags & BASE85_Z85_ENC) != 0;
-    bool useExt = (mode_flags & BASE85_EXT_ENC) != 0;
+static FORCE_INLINE void ascii85_digits(uint32_t value, char enc[5]) {
+    for (int j = 4; j >= 0; j--) {
+        enc[j] = (char)(value % 85 + 33);
+        value /= 85;
+    }
+}
 
-    if (isZ85) {
-        // Z85 requires input length multiple of 4
-        if (encoded_len % 4 != 0) {
-            return false;  // cannot encode
-        }
+static FORCE_INLINE void z85_digits(uint32_t value, char enc[5]) {
+    for (int j = 4; j >= 0; j--) {
+        enc[j] = BASE85_Z85_ENC_TABLE[value % 85];
+        value /= 85;
     }
+}
 
-    size_t index = 0;
-    size_t i = 0;
+#if TINY_CBASE_NEON
+
+// Z85 alphabet padded to 96 bytes for the 4+2 register lookup
+static const uint8_t BASE85_Z85_NEON_ENC_TABLE[96] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ.-:+=^!/*?&<>()[]{}@%$#";
+
+// Full 7-bit reverse table for the NEON lookups, 0xFF marks invalid
+static const uint8_t BASE85_Z85_NEON_REV_TABLE[128] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0x44, 0xFF, 0x54, 0x53, 0x52, 0x48, 0xFF, 0x4B, 0x4C, 0x46, 0x41, 0xFF, 0x3F, 0x3E, 0x45,
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x40, 0xFF, 0x49, 0x42, 0x4A, 0x47,
+    0x51, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32,
+    0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x4D, 0xFF, 0x4E, 0x43, 0xFF,
+    0xFF, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+    0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x4F, 0xFF, 0x50, 0xFF, 0xFF,
+};
 
-    // Full 4-byte blocks
-    for (; i + 3 < encoded_len; i += 4) {
-        uint32_t buf = read_u32_be(encoded_data + i);
+// v / 85 for all 32-bit v: multiply by ceil(2^38 / 85), keep the high bits
+static FORCE_INLINE uint32x4_t z85_div85_neon(uint32x4_t v) {
+    const uint32x2_t m = vdup_n_u32(0xC0C0C0C1u);
+    uint64x2_t lo = vmull_u32(vget_low_u32(v), m);
+    uint64x2_t hi = vmull_u32(vget_high_u32(v), m);
+    return vcombine_u32(vmovn_u64(vshrq_n_u64(lo, 38)), vmovn_u64(vshrq_n_u64(hi, 38)));
+}
 
-        // Shortcuts
-        if (!isZ85 && buf == 0) {
-            out_decoded[index++] = 'z';
-            continue;
-        }
-        
-        if (!isZ85 && useExt && buf == 0x20202020) {
-            out_decoded[index++] = 'y';
-            continue;
+// 64 bytes (16 big-endian words) -> 80 chars
+static FORCE_INLINE void z85_encode_neon(const uint8_t *in, char *out) {
+    const uint8x16x4_t t = neon_load_table4(BASE85_Z85_NEON_ENC_TABLE);
+    const uint8x16x2_t t2 = {{ vld1q_u8(BASE85_Z85_NEON_ENC_TABLE + 64), vld1q_u8(BASE85_Z85_NEON_ENC_TABLE + 80) }};
+    uint32x4_t v[4], r[4];
+    uint8x16_t d[5];
+
+    for (int q = 0; q < 4; q++) v[q] = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(in + 16 * q)));
+
+    // Digits from least significant, lane g of d[j] is digit j of word g
+    for (int j = 4; j >= 0; j--) {
+        for (int q = 0; q < 4; q++) {
+            uint32x4_t quot = z85_div85_neon(v[q]);
+            r[q] = vsubq_u32(v[q], vmulq_n_u32(quot, 85));
+            v[q] = quot;
         }
+        uint8x16_t digit = vcombine_u8(vmovn_u16(vcombine_u16(vmovn_u32(r[0]), vmovn_u32(r[1]))),
+                                       vmovn_u16(vcombine_u16(vmovn_u32(r[2]), vmovn_u32(r[3]))));
+        d[j] = vqtbx2q_u8(vqtbl4q_u8(t, digit), t2, vsubq_u8(digit, vdupq_n_u8(64)));
+    }
+    neon_scatter5(d, (uint8_t *)out);
+}
 
-        uint32_t tmp = buf;
-        char enc[5];
-
-        for (int j = 4; j >= 0; j--) {
-            enc[j] = (char)(tmp % 85);
-            tmp /= 85;
-        }
+// 80 chars -> 64 bytes; stores nothing and returns false on a bad char.
+// Words wrap modulo 2^32 like the scalar loop.
+static FORCE_INLINE bool z85_decode_neon(const char *in, uint8_t *out) {
+    const uint8x16x4_t t0 = neon_load_table4(BASE85_Z85_NEON_REV_TABLE);
+    const uint8x16x4_t t1 = neon_load_table4(BASE85_Z85_NEON_REV_TABLE + 64);
+    uint8x16_t c[5];
+    uint8x16_t bad = vdupq_n_u8(0);
+    uint32x4_t acc[4] = { vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0), vdupq_n_u32(0) };
+
+    neon_gather5((const uint8_t *)in, c);
+    for (int j = 0; j < 5; j++) c[j] = neon_lookup128(&t0, &t1, c[j], &bad);
+    if (neon_any_bad(bad)) return false;
+
+    for (int j = 0; j < 5; j++) {
+        uint16x8_t w0 = vmovl_u8(vget_low_u8(c[j]));
+        uint16x8_t w1 = vmovl_u8(vget_high_u8(c[j]));
+        acc[0] = vmlaq_n_u32(vmovl_u16(vget_low_u16(w0)), acc[0], 85);
+        acc[1] = vmlaq_n_u32(vmovl_u16(vget_high_u16(w0)), acc[1], 85);
+        acc[2] = vmlaq_n_u32(vmovl_u16(vget_low_u16(w1)), acc[2], 85);
+        acc[3] = vmlaq_n_u32(vmovl_u16(vget_high_u16(w1)), acc[3], 85);
+    }
+    for (int q = 0; q < 4; q++) vst1q_u8(out + 16 * q, vrev32q_u8(vreinterpretq_u8_u32(acc[q])));
+    return true;
+}
+
+#endif // TINY_CBASE_NEON
+
+// Appends `n` chars to the output, breaking the line every `line_len` chars
+// (0 = no wrapping, plain copy).
+static FORCE_INLINE void base85_emit(char *out, size_t *index, size_t *col, size_t line_len, const char *src, size_t n) {
+    if (!line_len) {
+        memcpy(out + *index, src, n);
+        *index += n;
+        return;
+    }
+
+    for (size_t j = 0; j < n; j++) {
+        if (*col == line_len) {
+            out[(*index)++] = '\n';
+            *col = 0;
+        }
+        out[(*index)++] = src[j];
+        (*col)++;
+    }
+}
+
+// Skips blanks, then matches `tag` at *pos.
+static bool btoa_parse_tag(const char *s, size_t len, size_t *pos, const char *tag) {
+    size_t i = *pos;
+    size_t n = strlen(tag);
+
+    while (i < len && (s[i] == ' ' || s[i] == '\t')) i++;
+    if (len - i < n || memcmp(s + i, tag, n) != 0) return false;
+
+    *pos = i + n;
+    return true;
+}
+
+// Skips blanks, then parses an unsigned decimal or hex number at *pos.
+static bool btoa_parse_number(const char *s, size_t len, size_t *pos, unsigned base, uint64_t *out) {
+    size_t i = *pos;
+    while (i < len && (s[i] == ' ' || s[i] == '\t')) i++;
+
+    size_t start = i;
+    uint64_t value = 0;
+    for (; i < len; i++) {
+        char c = s[i];
+        unsigned d;
+        if (c >= '0' && c <= '9') d = (unsigned)(c - '0');
+        else if (base == 16 && c >= 'a' && c <= 'f') d = (unsigned)(c - 'a' + 10);
+        else if (base == 16 && c >= 'A' && c <= 'F') d = (unsigned)(c - 'A' + 10);
+        else break;
+        value = value * base + d;
+    }
+    if (i == start) return false;
+
+    *pos = i;
+    *out = value;
+    return true;
+}
+
+// Parses the btoa trailer line starting at *pos; on success *pos points past its '\n'.
+static bool btoa_parse_trailer(const char *s, size_t len, size_t *pos, btoa_trailer_t *t) {
+    size_t i = *pos;
+
+    if (!btoa_parse_tag(s, len, &i, BTOA_TRAILER) ||
+        !btoa_parse_tag(s, len, &i, "N") ||
+        !btoa_parse_number(s, len, &i, 10, &t->n) ||
+        !btoa_parse_number(s, len, &i, 16, &t->n_hex) ||
+        !btoa_parse_tag(s, len, &i, "E") ||
+        !btoa_parse_number(s, len, &i, 16, &t->eor) ||
+        !btoa_parse_tag(s, len, &i, "S") ||
+        !btoa_parse_number(s, len, &i, 16, &t->sum) ||
+        !btoa_parse_tag(s, len, &i, "R") ||
+        !btoa_parse_number(s, len, &i, 16, &t->rot)) {
+        return false;
+    }
+
+    // Trailing blanks / '\r' up to and including the end of line
+    while (i < len && s[i] != '\n' && base_is_space(s[i])) i++;
+    if (i < len && s[i] == '\n') i++;
+
+    *pos = i;
+    return true;
+}
+
+// --- RFC 1924 (fixed-width 128-bit) ---
+
+// Splits a chunk (< 85^4) into two independent digit pairs to shorten the
+// dependency chain of the divisions.
+static FORCE_INLINE void rfc1924_encode_chunk(uint32_t chunk, char *out) {
+    uint32_t hi = chunk / (85 * 85);
+    uint32_t lo = chunk - hi * (85 * 85);
+
+    out[0] = BASE85_RFC1924_ENC_TABLE[hi / 85];
+    out[1] = BASE85_RFC1924_ENC_TABLE[hi % 85];
+    out[2] = BASE85_RFC1924_ENC_TABLE[lo / 85];
+    out[3] = BASE85_RFC1924_ENC_TABLE[lo % 85];
+}
+
+// The value is held as four big-endian 32-bit limbs. Each round divides it by
+// 85^4; every step is a 64-bit division by a constant, which compilers turn
+// into a reciprocal multiply, so no 128-bit division helper is involved.
+// The value shrinks by ~25.6 bits per round, so limbs that are known to be
+// zero are skipped and the last chunk is simply what is left in limb[3].
+static FORCE_INLINE void rfc1924_encode_one(const uint8_t *in, char *out) {
+    uint32_t limb[4] = { read_u32_be(in), read_u32_be(in + 4), read_u32_be(in + 8), read_u32_be(in + 12) };
+
+    for (int r = 0; r < 4; r++) {
+        uint64_t rem = 0;
+        for (int k = (r > 0) ? r - 1 : 0; k < 4; k++) {
+            uint64_t cur = (rem << 32) | limb[k];
+            limb[k] = (uint32_t)(cur / RFC1924_CHUNK);
+            rem = cur % RFC1924_CHUNK;
+        }
+        rfc1924_encode_chunk((uint32_t)rem, out + (4 - r) * 4);
+    }
+    rfc1924_encode_chunk(limb[3], out);
+}
+
+static FORCE_INLINE bool rfc1924_decode_one(const char *in, uint8_t *out) {
+    uint32_t limb[4] = { 0, 0, 0, 0 };
+
+    for (int r = 0; r < 5; r++) {
+        uint32_t chunk = 0;
+        for (int j = 0; j < 4; j++) {
+            unsigned char c = (unsigned char)in[r * 4 + j];
+            int8_t val = (c >= BASE85_RFC1924_MIN && c <= BASE85_RFC1924_MAX) ? BASE85_RFC1924_REV_TABLE[c - BASE85_RFC1924_MIN] : -1;
+            if (val < 0) return false; // invalid character
+            chunk = chunk * 85 + (uint32_t)val;
+        }
+
+        // value = value * 85^4 + chunk, touching only the limbs the value
+        // can occupy after r + 1 chunks; only the last round may overflow
+        uint64_t carry = chunk;
+        for (int k = 3; k >= ((r < 4) ? 3 - r : 0); k--) {
+            uint64_t cur = (uint64_t)limb[k] * RFC1924_CHUNK + carry;
+            limb[k] = (uint32_t)cur;
+            carry = cur >> 32;
+        }
+        if (carry) return false; // value does not fit in 128 bits
+    }
+
+    for (int k = 0; k < 4; k++) write_u32_be(out + k * 4, limb[k]);
+    return true;
+}
+
+bool BASE85_EncodeRfc1924(const uint8_t *data, char *out_encoded) {
+    if (!data || !out_encoded) return false;
+
+    rfc1924_encode_one(data, out_encoded);
+    out_encoded[RFC1924_CHARS] = '\0';
+    return true;
+}
+
+bool BASE85_DecodeRfc1924(const char *encoded_data, uint8_t *out_decoded) {
+    if (!encoded_data || !out_decoded) return false;
+
+    return rfc1924_decode_one(encoded_data, out_decoded);
+}
+
+bool BASE85_EncodeRfc1924Batch(const uint8_t *data, size_t count, char *out_encoded) {
+    if (!data || count == 0 || !out_encoded) return false;
+
+    for (size_t i = 0; i < count; i++) {
+        rfc1924_encode_one(data + i * RFC1924_BYTES, out_encoded + i * RFC1924_CHARS);
+    }
+
+    out_encoded[count * RFC1924_CHARS] = '\0';
+    return true;
+}
+
+bool BASE85_DecodeRfc1924Batch(const char *encoded_data, size_t count, uint8_t *out_decoded) {
+    if (!encoded_data || count == 0 || !out_decoded) return false;
+
+    for (size_t i = 0; i < count; i++) {
+        if (!rfc1924_decode_one(encoded_data + i * RFC1924_CHARS, out_decoded + i * RFC1924_BYTES)) return false;
+    }
+
+    return true;
+}
+
+#if TINY_CBASE_SSE2
+
+#define ASCII85_SIMD_BLOCK 32
+
+// Classifies 32 chars into bit masks: Ascii85 digits ('!'..'u'), ASCII
+// whitespace and shortcuts ('z', plus 'y' in extended mode). Signed compares
+// are fine: bytes >= 0x80 are negative and fall outside every class.
+static FORCE_INLINE void ascii85_classify(const char *p, bool useExt, uint32_t *digits, uint32_t *spaces, uint32_t *shortcuts) {
+#if TINY_CBASE_AVX2
+    __m256i v = _mm256_loadu_si256((const __m256i *)p);
+    __m256i d = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('!' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('u' + 1), v));
+    __m256i w = _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                                _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('\t' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), v)));
+    __m256i s = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(ASCII85_ZERO_SHORTCUT));
+    if (useExt) s = _mm256_or_si256(s, _mm256_cmpeq_epi8(v, _mm256_set1_epi8(ASCII85_SPACE_SHORTCUT)));
+
+    *digits = (uint32_t)_mm256_movemask_epi8(d);
+    *spaces = (uint32_t)_mm256_movemask_epi8(w);
+    *shortcuts = (uint32_t)_mm256_movemask_epi8(s);
+#else
+    uint32_t m[3] = { 0, 0, 0 };
+    for (int h = 0; h < 2; h++) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(p + h * 16));
+        __m128i d = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('!' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('u' + 1)));
+        __m128i w = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                 _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('\r' + 1))));
+        __m128i s = _mm_cmpeq_epi8(v, _mm_set1_epi8(ASCII85_ZERO_SHORTCUT));
+        if (useExt) s = _mm_or_si128(s, _mm_cmpeq_epi8(v, _mm_set1_epi8(ASCII85_SPACE_SHORTCUT)));
+
+        m[0] |= (uint32_t)_mm_movemask_epi8(d) << (h * 16);
+        m[1] |= (uint32_t)_mm_movemask_epi8(w) << (h * 16);
+        m[2] |= (uint32_t)_mm_movemask_epi8(s) << (h * 16);
+    }
+    *digits = m[0];
+    *spaces = m[1];
+    *shortcuts = m[2];
+#endif
+}
+
+// Converts four staged groups (20 digit values) in 32-bit lanes and stores
+// them as 16 big-endian bytes. SSE2 has no 32-bit multiply, so the Horner
+// step uses acc * 85 = acc * (64 + 16 + 4 + 1). Overflowing groups wrap
+// exactly like the scalar loop.
+static FORCE_INLINE void ascii85_groups4(const uint8_t *dg, uint8_t *out) {
+    __m128i acc = _mm_setzero_si128();
+
+    for (int j = 0; j < 5; j++) {
+        __m128i col = _mm_set_epi32(dg[15 + j], dg[10 + j], dg[5 + j], dg[j]);
+        acc = _mm_add_epi32(_mm_add_epi32(_mm_slli_epi32(acc, 6), _mm_slli_epi32(acc, 4)),
+                            _mm_add_epi32(_mm_slli_epi32(acc, 2), acc));
+        acc = _mm_add_epi32(acc, col);
+    }
+
+    // Byte swap each lane
+    acc = _mm_or_si128(_mm_slli_epi16(acc, 8), _mm_srli_epi16(acc, 8));
+    acc = _mm_shufflehi_epi16(_mm_shufflelo_epi16(acc, 0xB1), 0xB1);
+    _mm_storeu_si128((__m128i *)out, acc);
+}
+
+// Writes out the staged digits: four groups at a time while at least `keep`
+// digits remain, then (with keep == 0) the remaining whole groups one by one.
+// Leftover digits of an incomplete group are moved to the front.
+static FORCE_INLINE void ascii85_flush(uint8_t *dg, size_t *n, size_t keep, uint8_t *out, size_t *index, btoa_checksum_t *ck) {
+    size_t k = 0;
+
+    for (; *n - k >= 20 && *n - k >= keep; k += 20) {
+        ascii85_groups4(dg + k, out + *index);
+        if (ck) {
+            for (int g = 0; g < 4; g++) btoa_checksum_update(ck, read_u32_be(out + *index + g * 4));
+        }
+        *index += 16;
+    }
+
+    if (!keep) {
+        for (; *n - k >= 5; k += 5) {
+            uint32_t value = 0;
+            for (int j = 0; j < 5; j++) value = value * 85 + dg[k + (size_t)j];
+            write_u32_be(out + *index, value);
+            if (ck) btoa_checksum_update(ck, value);
+            *index += 4;
+        }
+    }
+
+    memmove(dg, dg + k, *n - k);
+    *n -= k;
+}
+
+// Vector front end of the Ascii85 decoder. Classifies 32 chars per step,
+// compacts the digits (dropping whitespace when skipWs) into a staging
+// buffer, expands the shortcuts and converts whole groups in vector lanes.
+// It stops at the first char it does not handle ('~', btoa 'x', invalid
+// chars, a shortcut inside a group, whitespace without skipWs) and hands
+// that position and the pending partial group over to the scalar loop.
+static void ascii85_decode_simd(const char *in, size_t len, size_t *pos, uint8_t *out, size_t *index,
+                                uint32_t *value, int *count, bool useExt, bool skipWs, btoa_checksum_t *ck) {
+    uint8_t dg[64]; // < 20 carried over + one block
+    size_t n = 0;
+    size_t i = *pos;
+    bool stop = false;
+
+    while (!stop && len - i >= ASCII85_SIMD_BLOCK) {
+        base_prefetch(in, i, len, ASCII85_SIMD_BLOCK);
+        uint32_t digits, spaces, shortcuts;
+        ascii85_classify(in + i, useExt, &digits, &spaces, &shortcuts);
+
+        uint32_t handled = digits | shortcuts | (skipWs ? spaces : 0);
+        size_t limit = (handled == 0xFFFFFFFFu) ? ASCII85_SIMD_BLOCK : base_ctz32(~handled);
+        uint32_t keep = (limit == ASCII85_SIMD_BLOCK) ? 0xFFFFFFFFu : ((1u << limit) - 1);
+
+        digits &= keep;
+        shortcuts &= keep;
+
+        if (digits == 0xFFFFFFFFu) {
+            // Pure digit block: digit values are simply ch - '!'
+            __m128i bias = _mm_set1_epi8('!');
+            _mm_storeu_si128((__m128i *)(dg + n), _mm_sub_epi8(_mm_loadu_si128((const __m128i *)(in + i)), bias));
+            _mm_storeu_si128((__m128i *)(dg + n + 16), _mm_sub_epi8(_mm_loadu_si128((const __m128i *)(in + i + 16)), bias));
+            n += ASCII85_SIMD_BLOCK;
+        } else {
+            for (uint32_t ev = digits | shortcuts; ev; ev &= ev - 1) {
+                unsigned p = base_ctz32(ev);
+                char c = in[i + p];
+
+                if (shortcuts & (1u << p)) {
+                    if (n % 5) { // not on a group boundary: let the scalar loop reject it
+                        limit = p;
+                        break;
+                    }
+                    ascii85_flush(dg, &n, 0, out, index, ck);
+                    uint32_t word = (c == ASCII85_ZERO_SHORTCUT) ? 0 : 0x20202020;
+                    write_u32_be(out + *index, word);
+                    if (ck) btoa_checksum_update(ck, word);
+                    *index += 4;
+                } else {
+                    dg[n++] = (uint8_t)(c - '!');
+                }
+            }
+        }
+
+        ascii85_flush(dg, &n, 20, out, index, ck);
+        i += limit;
+        stop = (limit < ASCII85_SIMD_BLOCK);
+    }
+
+    // Whole groups out, the incomplete one continues in the scalar loop
+    ascii85_flush(dg, &n, 0, out, index, ck);
+    for (size_t j = 0; j < n; j++) *value = *value * 85 + dg[j];
+    *count = (int)n;
+    *pos = i;
+}
+
+#endif // TINY_CBASE_SSE2
+
+static bool base85_decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len,
+                          size_t *out_consumed, int mode_flags, BASE_Error *err);
+
+static bool z85_encode_chunk(const uint8_t *in, size_t in_len, uint8_t *out, size_t *out_len, int mode_flags, BASE_Error *err) {
+    (void)err;
+    return BASE85_Encode(in, in_len, (char *)out, out_len, mode_flags);
+}
+
+static bool z85_decode_chunk(const uint8_t *in, size_t in_len, uint8_t *out, size_t *out_len, int mode_flags, BASE_Error *err) {
+    size_t consumed;
+    return base85_decode((const char *)in, in_len, out, out_len, &consumed, mode_flags, err);
+}
+
+// --- Encode Base85 / Z85 ---
+bool BASE85_Encode(const uint8_t *encoded_data, size_t encoded_len, char *out_decoded, size_t *out_decoded_len, int mode_flags) {
+    if (!encoded_data || !out_decoded || !out_decoded_len) return false;
+
+    bool isZ85 = (mode_flags & BASE85_Z85_ENC) != 0;
+    bool useExt = (mode_flags & BASE85_EXT_ENC) != 0;
+    bool isBtoa = !isZ85 && (mode_flags & BASE85_BTOA) != 0;
+    bool isFramed = !isZ85 && !isBtoa && (mode_flags & BASE85_ADOBE_FRAME) != 0;
+    bool z85Pad = isZ85 && (mode_flags & BASE85_Z85_PAD) != 0;
+
+    if (isZ85 && !z85Pad) {
+        // Z85 requires input length multiple of 4
+        if (encoded_len % 4 != 0) {
+            return false;  // cannot encode
+        }
+    }
+
+#if TINY_CBASE_STREAM
+    // Z85 only: Ascii85 output length depends on the data ('z'/'y' shortcuts)
+    if (isZ85 && base_stream_wanted(encoded_len / 4 * 5)) {
+        return base_stream_run(z85_encode_chunk, encoded_data, encoded_len, (uint8_t *)out_decoded, out_decoded_len, mode_flags, NULL, 4, 5);
+    }
+#endif
+
+    size_t index = 0;
+    size_t i = 0;
+
+    // Framing state: current column and wrap width (0 = unwrapped)
+    size_t col = 0;
+    size_t line_len = isBtoa ? BTOA_LINE_LEN : (isFramed ? ASCII85_FRAME_LINE_LEN : 0);
+    btoa_checksum_t ck = {0, 0, 0};
+
+    if (isBtoa) {
+        memcpy(out_decoded, BTOA_HEADER "\n", sizeof(BTOA_HEADER));
+        index += sizeof(BTOA_HEADER);
+    } else if (isFramed) {
+        base85_emit(out_decoded, &index, &col, line_len, ASCII85_FRAME_START, 2);
+    }
+
+#if TINY_CBASE_NEON
+    // Z85 output is never wrapped, so whole 64-byte runs go straight to the output
+    if (isZ85 && base_neon_available()) {
+        for (; encoded_len - i >= 64; i += 64, index += 80) {
+            base_prefetch(encoded_data, i, encoded_len, 64);
+            z85_encode_neon(encoded_data + i, out_decoded + index);
+        }
+    }
+#endif
+
+    // Full 4-byte blocks
+    for (; i + 3 < encoded_len; i += 4) {
+        uint32_t buf = read_u32_be(encoded_data + i);
+
+        if (isBtoa) btoa_checksum_update(&ck, buf);
+
+        // Shortcuts
+        if (!isZ85 && buf == 0) {
+            base85_emit(out_decoded, &index, &col, line_len, "z", 1);
+            continue;
+        }
+        
+        if (!isZ85 && useExt && buf == 0x20202020) {
+            base85_emit(out_decoded, &index, &col, line_len, "y", 1);
+            continue;
+        }
 
-        for (int j = 0; j < 5; j++) {
-            if (isZ85) enc[j] = BASE85_Z85_ENC_TABLE[(unsigned char)enc[j]];
-            else enc[j] += 33;
+        char enc[5];
+
+        if (isZ85) {
+            z85_digits(buf, enc);
+        } else {
+            ascii85_digits(buf, enc);
         }
 
-        memcpy(out_decoded + index, enc, 5);
-        index += 5;
+        base85_emit(out_decoded, &index, &col, line_len, enc, 5);
     }
 
     // Partial tail
     size_t tail = encoded_len - i;
-    if (!isZ85 && tail > 0) {
+    if (z85Pad && tail > 0) {
+        // Zero-padded last group cut to tail + 1 chars, as Ascii85 does
         uint32_t buf = 0;
         for (size_t j = 0; j < tail; j++) buf |= (uint32_t)encoded_data[i + j] << (24 - 8 * j);
 
-        uint32_t tmp = buf;
         char enc[5];
-        for (int j = 4; j >= 0; j--) {
-            enc[j] = (char)(tmp % 85);
-            tmp /= 85;
-        }
+        z85_digits(buf, enc);
+        memcpy(out_decoded + index, enc, tail + 1);
+        index += tail + 1;
+    } else if (!isZ85 && tail > 0) {
+        uint32_t buf = 0;
+        for (size_t j = 0; j < tail; j++) buf |= (uint32_t)encoded_data[i + j] << (24 - 8 * j);
 
-        for (int j = 0; j < 5; j++) {
-            enc[j] += 33;
+        char enc[5];
+        ascii85_digits(buf, enc);
+
+        if (isBtoa) {
+            // btoa zero-pads the last group and writes it in full;
+            // the trailer's byte count tells the decoder where data ends
+            btoa_checksum_update(&ck, buf);
+            if (buf == 0) base85_emit(out_decoded, &index, &col, line_len, "z", 1);
+            else base85_emit(out_decoded, &index, &col, line_len, enc, 5);
+        } else {
+            base85_emit(out_decoded, &index, &col, line_len, enc, tail + 1);
         }
+    }
 
-        for (size_t j = 0; j < tail + 1; j++) {
-            out_decoded[index++] = enc[j];
+    if (isFramed) {
+        // "~>" is one token: never split it across lines
+        if (col + 2 > line_len) {
+            out_decoded[index++] = '\n';
+            col = 0;
         }
+        memcpy(out_decoded + index, ASCII85_FRAME_END, 2);
+        index += 2;
+    } else if (isBtoa) {
+        if (col) out_decoded[index++] = '\n';
+        int n = snprintf(out_decoded + index, BTOA_TRAILER_MAX, BTOA_TRAILER " N %llu %llx E %x S %x R %x\n",
+                         (unsigned long long)encoded_len, (unsigned long long)encoded_len,
+                         (unsigned)ck.eor, (unsigned)ck.sum, (unsigned)ck.rot);
+        if (n < 0) return false;
+        index += (size_t)n;
     }
 
     out_decoded[index] = '\0';
@@ -580,8 +2520,9 @@ bool BASE85_Encode(const uint8_t *encoded_data, size_t encoded_len, char *out_de
 }
 
 // // --- Decode Base85 / Z85 ---
-bool BASE85_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags) {
-    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len) return false;
+static bool base85_decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len,
+                          size_t *out_consumed, int mode_flags, BASE_Error *err) {
+    if (!encoded_data || encoded_len == 0 || !out_decoded || !out_decoded_len || !out_consumed) return base_fail(err, BASE_ERR_ARGS, NULL, 0);
 
 #if BASE_TRUNCATE_ON_NULL
     // Adjust encoded_len if null terminator appears before
@@ -595,14 +2536,29 @@ bool BASE85_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
 
     bool isZ85 = (mode_flags & BASE85_Z85_DEC) != 0;
     bool useExt = (mode_flags & BASE85_EXT_DEC) != 0;
+    bool isBtoa = !isZ85 && (mode_flags & BASE85_BTOA) != 0;
+    bool isFramed = !isZ85 && !isBtoa && (mode_flags & BASE85_ADOBE_FRAME) != 0;
+    bool z85Pad = isZ85 && (mode_flags & BASE85_Z85_PAD) != 0;
+
+    // Whitespace (line breaks) is part of both framed formats
+    bool skipWs = isBtoa || isFramed || (mode_flags & BASE85_IGNORE_WS);
 
     if (isZ85) {
-        // Z85 decoding requires input length multiple of 5 characters
-        if (encoded_len % 5 != 0) {
-            return false;  // invalid input length for Z85
+        // Z85 decoding requires input length multiple of 5 characters; padded
+        // Z85 may end in a 2..4 char partial group
+        if (encoded_len % 5 != 0 && (!z85Pad || encoded_len % 5 == 1)) {
+            return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, encoded_len);
         }
     }
 
+#if TINY_CBASE_STREAM
+    // Z85 without whitespace only: the partial group of padded Z85 ends the last chunk
+    if (isZ85 && !skipWs && base_stream_wanted(encoded_len / 5 * 4)) {
+        *out_consumed = encoded_len;
+        return base_stream_run(z85_decode_chunk, (const uint8_t *)encoded_data, encoded_len, out_decoded, out_decoded_len, mode_flags, err, 5, 4);
+    }
+#endif
+
     const int8_t *rev_table = isZ85 ? BASE85_Z85_REV_TABLE : BASE85_ASCII85_REV_TABLE;
     char min_char = isZ85 ? BASE85_Z85_MIN : BASE85_ASCII85_MIN;
     char max_char = isZ85 ? BASE85_Z85_MAX : BASE85_ASCII85_MAX;
@@ -610,21 +2566,76 @@ bool BASE85_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
     size_t index = 0;
     uint32_t value = 0;
     int count = 0;
+    size_t i = 0;
+
+    btoa_checksum_t ck = {0, 0, 0};
+    btoa_trailer_t trailer;
+
+    // Unframed input ends with the buffer, framed input with its closing marker
+    bool terminated = !(isBtoa || isFramed);
+
+    if (isBtoa || isFramed) {
+        while (i < encoded_len && base_is_space(encoded_data[i])) i++;
+
+        if (isBtoa) {
+            // "xbtoa Begin" and the rest of its line
+            if (!btoa_parse_tag(encoded_data, encoded_len, &i, BTOA_HEADER)) return base_fail(err, BASE_ERR_BAD_FRAME, NULL, i);
+            while (i < encoded_len && encoded_data[i] != '\n') i++;
+        } else if (encoded_len - i >= 2 && encoded_data[i] == '<' && encoded_data[i + 1] == '~') {
+            i += 2; // "<~" is optional (PDF streams only carry the "~>" EOD marker)
+        }
+    }
+
+#if TINY_CBASE_NEON
+    // Whitespace or a bad char ends the vector loop; the scalar loop takes over there
+    if (isZ85 && base_neon_available()) {
+        for (; encoded_len - i >= 80; i += 80, index += 64) {
+            base_prefetch(encoded_data, i, encoded_len, 80);
+            if (!z85_decode_neon(encoded_data + i, out_decoded + index)) break;
+        }
+    }
+#endif
+
+#if TINY_CBASE_SSE2
+    if (!isZ85) {
+        ascii85_decode_simd(encoded_data, encoded_len, &i, out_decoded, &index, &value, &count,
+                            useExt, skipWs, isBtoa ? &ck : NULL);
+    }
+#endif
 
-    for (size_t i = 0; i < encoded_len; i++) {
+    for (; i < encoded_len; i++) {
         char c = encoded_data[i];
 
         // Ignore whitespace if flag is set
-        if ((mode_flags & BASE85_IGNORE_WS) && isspace((unsigned char)c)) continue;
+        if (skipWs && base_is_space(c)) continue;
+
+        // End of data markers
+        if (isFramed && c == '~') {
+            // Writers that wrap "~>" like body text put a line break inside it
+            size_t gt = i + 1;
+            while (gt < encoded_len && base_is_space(encoded_data[gt])) gt++;
+            if (gt >= encoded_len || encoded_data[gt] != '>') return base_fail(err, BASE_ERR_BAD_FRAME, NULL, i);
+            i = gt + 1;
+            terminated = true;
+            break;
+        }
+        if (isBtoa && c == 'x') {
+            size_t at = i;
+            if (!btoa_parse_trailer(encoded_data, encoded_len, &i, &trailer)) return base_fail(err, BASE_ERR_BAD_FRAME, NULL, at);
+            terminated = true;
+            break;
+        }
 
         // Shortcuts (ASCII85 only)
         if (!isZ85 && c == ASCII85_ZERO_SHORTCUT && count == 0) { 
             write_u32_be(out_decoded + index, 0); 
+            if (isBtoa) btoa_checksum_update(&ck, 0);
             index += 4; 
             continue; 
         }
         if (!isZ85 && useExt && c == ASCII85_SPACE_SHORTCUT && count == 0) { 
             write_u32_be(out_decoded + index, 0x20202020); 
+            if (isBtoa) btoa_checksum_update(&ck, 0x20202020);
             index += 4; 
             continue; 
         }
@@ -635,7 +2646,7 @@ bool BASE85_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
             val = rev_table[(unsigned char)c - (unsigned char)min_char];
         }
         if (val < 0) {
-            return false; // invalid character
+            return base_fail(err, BASE_ERR_INVALID_CHAR, encoded_data, i);
         }
 
         value = value * 85 + (uint32_t)val;
@@ -643,16 +2654,25 @@ bool BASE85_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
 
         if (count == 5) {
             write_u32_be(out_decoded + index, value);
+            if (isBtoa) btoa_checksum_update(&ck, value);
             index += 4;
             value = 0;
             count = 0;
         }
     }
 
-    // Handle partial final block (ASCII85 only)
-    if (!isZ85 && count > 0) {
+    if (!terminated) return base_fail(err, BASE_ERR_BAD_FRAME, NULL, encoded_len); // missing "~>" or btoa trailer
+
+    if (isBtoa) {
+        // btoa always writes whole groups; the trailer carries the real length
+        if (count != 0 || trailer.n != trailer.n_hex || (trailer.n + 3) / 4 * 4 != index) return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, i);
+        if (trailer.eor != ck.eor || trailer.sum != ck.sum || trailer.rot != ck.rot) return base_fail(err, BASE_ERR_CHECKSUM, NULL, i);
+        index = (size_t)trailer.n;
+    } else if ((!isZ85 || z85Pad) && count > 0) {
+        // Handle partial final block (ASCII85 and padded Z85)
+        if (isZ85 && count == 1) return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, encoded_len);
         for (int j = count; j < 5; j++) {
-            value = value * 85 + 84; // pad with 'u'
+            value = value * 85 + 84; // pad with the top digit ('u', '#' in Z85)
         }
         for (int j = 0; j < count - 1; j++) {
             out_decoded[index + (size_t)j] = (uint8_t)(value >> (24 - j * 8));
@@ -660,14 +2680,2073 @@ bool BASE85_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
         index += (size_t)(count - 1);
     } else if (isZ85 && count != 0) {
         // Z85 cannot have partial blocks
-        return false;
+        return base_fail(err, BASE_ERR_BAD_LENGTH, NULL, encoded_len);
     }
 
     *out_decoded_len = index;
+    *out_consumed = i;
     return true;
 }
 
+bool BASE85_DecodeFramed(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len,
+                         size_t *out_consumed, int mode_flags) {
+    return base85_decode(encoded_data, encoded_len, out_decoded, out_decoded_len, out_consumed, mode_flags, NULL);
+}
+
+bool BASE85_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags) {
+    size_t consumed;
+    return BASE85_DecodeFramed(encoded_data, encoded_len, out_decoded, out_decoded_len, &consumed, mode_flags);
+}
+
 #endif // TINY_CBASE_ENABLE_BASE85
 
+// // --- Detailed errors ---
+const char *BASE_ErrorString(BASE_ErrorCode reason) {
+    switch (reason) {
+        case BASE_ERR_NONE:         return "no error";
+        case BASE_ERR_ARGS:         return "invalid arguments";
+        case BASE_ERR_INVALID_CHAR: return "invalid character";
+        case BASE_ERR_BAD_PADDING:  return "bad padding";
+        case BASE_ERR_BAD_LENGTH:   return "bad length";
+        case BASE_ERR_BAD_FRAME:    return "bad framing";
+        case BASE_ERR_CHECKSUM:     return "checksum mismatch";
+    }
+    return "unknown error";
+}
+
+bool BASE_DecodeEx(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags, BASE_Error *err) {
+    if (err) {
+        err->reason = BASE_ERR_NONE;
+        err->offset = 0;
+        err->ch = 0;
+    }
+
+#if TINY_CBASE_ENABLE_BASE16
+    if (mode_flags & BASE16_DECODE) {
+        if (mode_flags & BASE_CONST_TIME) return base16_decode_ct(encoded_data, encoded_len, out_decoded, out_decoded_len, err);
+        return base16_decode(encoded_data, encoded_len, out_decoded, out_decoded_len, err);
+    }
+#endif
+
+#if TINY_CBASE_ENABLE_BASE32
+    if (mode_flags & BASE32_DEC) {
+        return base32_decode(encoded_data, encoded_len, out_decoded, out_decoded_len, mode_flags, err);
+    }
+#endif
+
+#if TINY_CBASE_ENABLE_BASE58
+    if (mode_flags & BASE58_DEC) {
+        return base58_decode(encoded_data, encoded_len, out_decoded, out_decoded_len, err);
+    }
+#endif
+
+#if TINY_CBASE_ENABLE_BASE64
+    if (mode_flags & (BASE64_STD_DEC | BASE64_URL_DEC | BASE64_NOPAD_DEC | BASE64_FORGIVING_DEC)) {
+        return base64_decode(encoded_data, encoded_len, out_decoded, out_decoded_len, mode_flags, err);
+    }
+#endif
+
+#if TINY_CBASE_ENABLE_BASE85
+    if (mode_flags & (BASE85_STD_DEC | BASE85_EXT_DEC | BASE85_Z85_DEC)) {
+        size_t consumed;
+        return base85_decode(encoded_data, encoded_len, out_decoded, out_decoded_len, &consumed, mode_flags, err);
+    }
+#endif
+
+    return base_fail(err, BASE_ERR_ARGS, NULL, 0); // unknown mode
+}
+
+// // --- Encoding detection ---
+
+// Character classes, one bit each in the presence bitmap
+#define BASE_CC_ZERO   0x00001 // '0'
+#define BASE_CC_ONE    0x00002 // '1'
+#define BASE_CC_D27    0x00004 // '2'-'7'
+#define BASE_CC_D89    0x00008 // '8', '9'
+#define BASE_CC_HEXU   0x00010 // 'A'-'F'
+#define BASE_CC_IO     0x00020 // 'I', 'O'
+#define BASE_CC_UPPER  0x00040 // other upper case
+#define BASE_CC_HEXL   0x00080 // 'a'-'f'
+#define BASE_CC_L      0x00100 // 'l'
+#define BASE_CC_LOWER  0x00200 // other lower case
+#define BASE_CC_PLUS   0x00400 // '+'
+#define BASE_CC_SLASH  0x00800 // '/'
+#define BASE_CC_DASH   0x01000 // '-'
+#define BASE_CC_UNDER  0x02000 // '_'
+#define BASE_CC_EQ     0x04000 // '='
+#define BASE_CC_Z85P   0x08000 // rest of the Z85 punctuation
+#define BASE_CC_WS     0x10000 // ASCII whitespace
+#define BASE_CC_OTHER  0x20000 // anything else
+
+#define BASE_CC_DIGITS (BASE_CC_ZERO | BASE_CC_ONE | BASE_CC_D27 | BASE_CC_D89)
+#define BASE_CC_ALNUM  (BASE_CC_DIGITS | BASE_CC_HEXU | BASE_CC_IO | BASE_CC_UPPER | BASE_CC_HEXL | BASE_CC_L | BASE_CC_LOWER)
+
+// Alphabet membership masks
+#define BASE_CC_SET_HEX    (BASE_CC_DIGITS | BASE_CC_HEXU | BASE_CC_HEXL)
+#define BASE_CC_SET_B32    (BASE_CC_D27 | BASE_CC_HEXU | BASE_CC_IO | BASE_CC_UPPER | BASE_CC_EQ)
+#define BASE_CC_SET_B58    (BASE_CC_ONE | BASE_CC_D27 | BASE_CC_D89 | BASE_CC_HEXU | BASE_CC_UPPER | BASE_CC_HEXL | BASE_CC_LOWER)
+#define BASE_CC_SET_B64    (BASE_CC_ALNUM | BASE_CC_PLUS | BASE_CC_SLASH | BASE_CC_EQ)
+#define BASE_CC_SET_B64URL (BASE_CC_ALNUM | BASE_CC_DASH | BASE_CC_UNDER | BASE_CC_EQ)
+#define BASE_CC_SET_Z85    (BASE_CC_ALNUM | BASE_CC_PLUS | BASE_CC_SLASH | BASE_CC_DASH | BASE_CC_EQ | BASE_CC_Z85P)
+
+static uint32_t base_detect_class(unsigned char c) {
+    if (c == '0') return BASE_CC_ZERO;
+    if (c == '1') return BASE_CC_ONE;
+    if (c >= '2' && c <= '7') return BASE_CC_D27;
+    if (c == '8' || c == '9') return BASE_CC_D89;
+    if (c >= 'A' && c <= 'F') return BASE_CC_HEXU;
+    if (c == 'I' || c == 'O') return BASE_CC_IO;
+    if (c >= 'G' && c <= 'Z') return BASE_CC_UPPER;
+    if (c >= 'a' && c <= 'f') return BASE_CC_HEXL;
+    if (c == 'l') return BASE_CC_L;
+    if (c >= 'g' && c <= 'z') return BASE_CC_LOWER;
+    if (c == '+') return BASE_CC_PLUS;
+    if (c == '/') return BASE_CC_SLASH;
+    if (c == '-') return BASE_CC_DASH;
+    if (c == '_') return BASE_CC_UNDER;
+    if (c == '=') return BASE_CC_EQ;
+    if (c != 0 && strchr(".:^!*?&<>()[]{}@%$#", c)) return BASE_CC_Z85P;
+    if (base_is_space((char)c)) return BASE_CC_WS;
+    return BASE_CC_OTHER;
+}
+
+#if TINY_CBASE_SSE2
+// All-ones lanes where lo <= v <= hi (unsigned)
+static FORCE_INLINE __m128i base_in_range(__m128i v, char lo, char hi) {
+    __m128i d = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_subs_epu8(d, _mm_set1_epi8((char)(hi - lo))), _mm_setzero_si128());
+}
+
+static FORCE_INLINE __m128i base_is(__m128i v, char c) {
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+
+// Folds a class mask into the per-lane bit accumulator
+#define BASE_CC_ACC(acc, m, bit) ((acc) = _mm_or_si128((acc), _mm_and_si128((m), _mm_set1_epi8((char)(bit)))))
+
+// Presence bitmap of data[0 .. len & ~15], 16 chars per step. Each lane of
+// lo/hi/top collects the class bits it has seen; lanes are merged at the end.
+// Whitespace is also counted, for the forgiving Base64 length rule.
+static uint32_t base_detect_classes_sse2(const char *data, size_t len, size_t *ws_count) {
+    __m128i lo = _mm_setzero_si128();  // classes 0-7
+    __m128i hi = _mm_setzero_si128();  // classes 8-15
+    __m128i top = _mm_setzero_si128(); // classes 16-17
+
+    for (size_t i = 0; len - i >= 16; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(data + i));
+
+        __m128i zero = base_is(v, '0');
+        __m128i one = base_is(v, '1');
+        __m128i d27 = base_in_range(v, '2', '7');
+        __m128i d89 = base_in_range(v, '8', '9');
+        __m128i hexu = base_in_range(v, 'A', 'F');
+        __m128i io = _mm_or_si128(base_is(v, 'I'), base_is(v, 'O'));
+        __m128i upper = _mm_andnot_si128(io, base_in_range(v, 'G', 'Z'));
+        __m128i hexl = base_in_range(v, 'a', 'f');
+        __m128i l = base_is(v, 'l');
+        __m128i lower = _mm_andnot_si128(l, base_in_range(v, 'g', 'z'));
+        __m128i plus = base_is(v, '+');
+        __m128i slash = base_is(v, '/');
+        __m128i dash = base_is(v, '-');
+        __m128i under = base_is(v, '_');
+        __m128i eq = base_is(v, '=');
+        __m128i z85p = _mm_or_si128(
+            _mm_or_si128(_mm_or_si128(base_is(v, '!'), base_in_range(v, '#', '&')),
+                         _mm_or_si128(base_in_range(v, '(', '*'), base_is(v, '.'))),
+            _mm_or_si128(
+                _mm_or_si128(_mm_or_si128(base_is(v, ':'), base_is(v, '<')), _mm_or_si128(base_in_range(v, '>', '@'), base_is(v, '['))),
+                _mm_or_si128(_mm_or_si128(base_is(v, ']'), base_is(v, '^')), _mm_or_si128(base_is(v, '{'), base_is(v, '}')))));
+        __m128i ws = _mm_or_si128(base_is(v, ' '), base_in_range(v, '\t', '\r'));
+
+        BASE_CC_ACC(lo, zero, 0x01);
+        BASE_CC_ACC(lo, one, 0x02);
+        BASE_CC_ACC(lo, d27, 0x04);
+        BASE_CC_ACC(lo, d89, 0x08);
+        BASE_CC_ACC(lo, hexu, 0x10);
+        BASE_CC_ACC(lo, io, 0x20);
+        BASE_CC_ACC(lo, upper, 0x40);
+        BASE_CC_ACC(lo, hexl, 0x80);
+        BASE_CC_ACC(hi, l, 0x01);
+        BASE_CC_ACC(hi, lower, 0x02);
+        BASE_CC_ACC(hi, plus, 0x04);
+        BASE_CC_ACC(hi, slash, 0x08);
+        BASE_CC_ACC(hi, dash, 0x10);
+        BASE_CC_ACC(hi, under, 0x20);
+        BASE_CC_ACC(hi, eq, 0x40);
+        BASE_CC_ACC(hi, z85p, 0x80);
+        BASE_CC_ACC(top, ws, 0x01);
+        for (uint32_t m = (uint32_t)_mm_movemask_epi8(ws); m; m &= m - 1) (*ws_count)++;
+
+        // Every lane belongs to exactly one class, so "other" is whatever got no bit
+        __m128i known = _mm_or_si128(_mm_or_si128(_mm_or_si128(zero, one), _mm_or_si128(d27, d89)),
+                                     _mm_or_si128(_mm_or_si128(hexu, io), _mm_or_si128(upper, hexl)));
+        known = _mm_or_si128(known, _mm_or_si128(_mm_or_si128(_mm_or_si128(l, lower), _mm_or_si128(plus, slash)),
+                                                 _mm_or_si128(_mm_or_si128(dash, under), _mm_or_si128(eq, z85p))));
+        known = _mm_or_si128(known, ws);
+        BASE_CC_ACC(top, _mm_cmpeq_epi8(known, _mm_setzero_si128()), 0x02);
+    }
+
+    uint8_t b_lo[16], b_hi[16], b_top[16];
+    _mm_storeu_si128((__m128i *)b_lo, lo);
+    _mm_storeu_si128((__m128i *)b_hi, hi);
+    _mm_storeu_si128((__m128i *)b_top, top);
+
+    uint32_t mask = 0;
+    for (int j = 0; j < 16; j++) mask |= (uint32_t)b_lo[j] | ((uint32_t)b_hi[j] << 8) | ((uint32_t)b_top[j] << 16);
+    return mask;
+}
+#endif // TINY_CBASE_SSE2
+
+// '=' may only appear as trailing padding, at most max_pad of them
+static FORCE_INLINE bool base_detect_pad_ok(const char *data, size_t len, size_t pads, size_t max_pad) {
+    return pads <= max_pad && !memchr(data, '=', len - pads);
+}
+
+size_t BASE_Detect(const char *data, size_t data_len, int *out_modes, size_t max_modes) {
+    if (!data || data_len == 0 || !out_modes || max_modes == 0) return 0;
+
+    size_t i = 0;
+    size_t ws_count = 0;
+    uint32_t mask = 0;
+
+#if TINY_CBASE_SSE2
+    mask = base_detect_classes_sse2(data, data_len, &ws_count);
+    i = data_len & ~(size_t)15;
+#endif
+    for (; i < data_len; i++) {
+        uint32_t cc = base_detect_class((unsigned char)data[i]);
+        if (cc == BASE_CC_WS) ws_count++;
+        mask |= cc;
+    }
+
+    size_t pads = 0;
+    while (pads < data_len && data[data_len - 1 - pads] == '=') pads++;
+
+    int found[BASE_DETECT_MAX];
+    size_t n = 0;
+
+    // Ranked from the smallest alphabet to the largest: text that fits a small
+    // alphabet is unlikely to be a larger-alphabet encoding by chance
+#if TINY_CBASE_ENABLE_BASE16
+    if (!(mask & ~BASE_CC_SET_HEX) && data_len % 2 == 0) found[n++] = BASE16_DECODE;
+#endif
+
+#if TINY_CBASE_ENABLE_BASE32
+    if (!(mask & ~BASE_CC_SET_B32) && base_detect_pad_ok(data, data_len, pads, 6)) {
+        if (data_len % 8 == 0) found[n++] = BASE32_DEC;
+        else if (pads == 0) found[n++] = BASE32_DEC | BASE32_DEC_NOPAD;
+    }
+#endif
+
+#if TINY_CBASE_ENABLE_BASE58
+    if (!(mask & ~BASE_CC_SET_B58)) found[n++] = BASE58_DEC;
+#endif
+
+#if TINY_CBASE_ENABLE_BASE64
+    bool b64_len_ok = base_detect_pad_ok(data, data_len, pads, 2) && (data_len % 4 == 0 || (pads == 0 && data_len % 4 != 1));
+    int b64_nopad = (data_len % 4 == 0) ? 0 : BASE64_NOPAD_DEC;
+
+    if (!(mask & ~BASE_CC_SET_B64) && b64_len_ok) found[n++] = BASE64_STD_DEC | b64_nopad;
+    if (!(mask & ~BASE_CC_SET_B64URL) && b64_len_ok) found[n++] = BASE64_URL_DEC | b64_nopad;
+#endif
+
+#if TINY_CBASE_ENABLE_BASE85
+    if (!(mask & ~BASE_CC_SET_Z85) && data_len % 5 == 0) found[n++] = BASE85_Z85_DEC;
+#endif
+
+#if TINY_CBASE_ENABLE_BASE64
+    // Line-wrapped Base64 (MIME, PEM): only the forgiving decoder skips whitespace
+    if ((mask & BASE_CC_WS) && !(mask & ~(BASE_CC_SET_B64 | BASE_CC_WS))) {
+        const char *pad = (const char *)memchr(data, '=', data_len);
+        size_t ws_pads = 0;
+        bool ok = !memchr(data, '\v', data_len); // not HTML whitespace
+
+        for (size_t j = pad ? (size_t)(pad - data) : data_len; j < data_len && ok; j++) {
+            if (data[j] == '=') ws_pads++;
+            else ok = base_is_space(data[j]);
+        }
+
+        size_t sextets = data_len - ws_count - ws_pads;
+        // As in the decoder: padding, if any, must complete a 2- or 3-char quantum to 4
+        if (ok && sextets % 4 != 1 && (ws_pads == 0 || (sextets % 4 >= 2 && sextets % 4 + ws_pads == 4))) {
+            found[n++] = BASE64_STD_DEC | BASE64_FORGIVING_DEC;
+        }
+    }
+#endif
+
+    if (n > max_modes) n = max_modes;
+    memcpy(out_modes, found, n * sizeof(int));
+    return n;
+}
+
+
+// --- Parallel encode/decode ---
+
+// Quanta at the end of each range that are coded through a stack buffer
+#define BASE_PAR_TAIL_QUANTA 16
+
+static FORCE_INLINE bool base_par_set(base_chunk_fn *fn, size_t *in_q, size_t *out_q, base_chunk_fn f, size_t iq, size_t oq) {
+    *fn = f;
+    *in_q = iq;
+    *out_q = oq;
+    return true;
+}
+
+// Codec of mode_flags if it splits at quantum boundaries (in_q input units to
+// out_q output units, each quantum coded on its own). Same precedence as
+// BASE_GetEncodeLen/BASE_DecodeEx.
+static bool base_par_codec(int mode_flags, bool encode, base_chunk_fn *fn, size_t *in_q, size_t *out_q) {
+    if (encode) {
+#if TINY_CBASE_ENABLE_BASE16
+        if (mode_flags & (BASE16_UPPER | BASE16_LOWER)) return base_par_set(fn, in_q, out_q, base16_encode_chunk, 1, 2);
+#endif
+#if TINY_CBASE_ENABLE_BASE32
+        if (mode_flags & BASE32_ENC) return base_par_set(fn, in_q, out_q, base32_encode_chunk, 5, 8);
+#endif
+#if TINY_CBASE_ENABLE_BASE58
+        if (mode_flags & BASE58_ENC) return false;
+#endif
+#if TINY_CBASE_ENABLE_BASE64
+        if (mode_flags & (BASE64_STD_ENC | BASE64_URL_ENC | BASE64_NOPAD_ENC)) return base_par_set(fn, in_q, out_q, base64_encode_chunk, 3, 4);
+#endif
+#if TINY_CBASE_ENABLE_BASE85
+        if (mode_flags & BASE85_Z85_ENC) return base_par_set(fn, in_q, out_q, z85_encode_chunk, 4, 5);
+#endif
+        return false;
+    }
+
+#if TINY_CBASE_ENABLE_BASE16
+    if (mode_flags & BASE16_DECODE) return base_par_set(fn, in_q, out_q, base16_decode_chunk, 2, 1);
+#endif
+#if TINY_CBASE_ENABLE_BASE32
+    if (mode_flags & BASE32_DEC) return base_par_set(fn, in_q, out_q, base32_decode_chunk, 8, 5);
+#endif
+#if TINY_CBASE_ENABLE_BASE58
+    if (mode_flags & BASE58_DEC) return false;
+#endif
+#if TINY_CBASE_ENABLE_BASE64
+    // The constant-time and forgiving decoders judge padding over the whole input
+    if (mode_flags & (BASE64_STD_DEC | BASE64_URL_DEC | BASE64_NOPAD_DEC | BASE64_FORGIVING_DEC)) {
+        if (mode_flags & (BASE64_FORGIVING_DEC | BASE_CONST_TIME)) return false;
+        return base_par_set(fn, in_q, out_q, base64_decode_chunk, 4, 3);
+    }
+#endif
+#if TINY_CBASE_ENABLE_BASE85
+    if ((mode_flags & BASE85_Z85_DEC) && !(mode_flags & BASE85_IGNORE_WS)) {
+        return base_par_set(fn, in_q, out_q, z85_decode_chunk, 5, 4);
+    }
+#endif
+    return false;
+}
+
+#if TINY_CBASE_NUMA
+
+#define BASE_NUMA_MAX_NODES 64
+
+// NUMA nodes that have CPUs this process may run on, read once from sysfs
+static struct {
+    int count;
+    int id[BASE_NUMA_MAX_NODES];         // kernel node number
+    cpu_set_t cpus[BASE_NUMA_MAX_NODES]; // allowed CPUs of the node
+} base_numa;
+static pthread_once_t base_numa_once = PTHREAD_ONCE_INIT;
+
+// Parses a sysfs list file ("0-3,8-11") into a set
+static bool base_numa_read_list(const char *path, cpu_set_t *set) {
+    char buf[4096];
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    size_t n = fread(buf, 1, sizeof(buf) - 1, f);
+    fclose(f);
+    buf[n] = '\0';
+
+    CPU_ZERO(set);
+    for (const char *s = buf;;) {
+        char *end;
+        unsigned long lo = strtoul(s, &end, 10), hi = lo;
+        if (end == s) break;
+        if (*end == '-') hi = strtoul(end + 1, &end, 10);
+        for (; lo <= hi && lo < CPU_SETSIZE; lo++) CPU_SET(lo, set);
+        if (*end != ',') break;
+        s = end + 1;
+    }
+    return true;
+}
+
+static void base_numa_load(void) {
+    cpu_set_t online, allowed;
+    if (!base_numa_read_list("/sys/devices/system/node/online", &online)) return;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+
+    for (int node = 0; node < CPU_SETSIZE && base_numa.count < BASE_NUMA_MAX_NODES; node++) {
+        char path[64];
+        cpu_set_t cpus;
+        if (!CPU_ISSET(node, &online)) continue;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        if (!base_numa_read_list(path, &cpus)) continue;
+        CPU_AND(&cpus, &cpus, &allowed);
+        if (CPU_COUNT(&cpus) == 0) continue; // memory-only node, or outside our cpuset
+
+        base_numa.id[base_numa.count] = node;
+        base_numa.cpus[base_numa.count++] = cpus;
+    }
+}
+
+// Topology slot of a kernel node number, -1 if it has no usable CPUs
+static int base_numa_slot(int node) {
+    for (int k = 0; k < base_numa.count; k++) {
+        if (base_numa.id[k] == node) return k;
+    }
+    return -1;
+}
+
+// Slot of the node holding each page (move_pages(2) in query mode), -1 where unknown
+static void base_numa_page_slots(const void **pages, int *slots, size_t count) {
+    long rc = -1;
+#ifdef SYS_move_pages
+    rc = syscall(SYS_move_pages, 0, (unsigned long)count, pages, NULL, slots, 0);
+#endif
+    for (size_t i = 0; i < count; i++) {
+        slots[i] = (rc == 0 && slots[i] >= 0) ? base_numa_slot(slots[i]) : -1;
+    }
+}
+
+// Slot of the node the calling thread runs on, -1 if unknown
+static int base_numa_current_slot(void) {
+    int cpu = sched_getcpu();
+    for (int k = 0; cpu >= 0 && k < base_numa.count; k++) {
+        if (CPU_ISSET(cpu, &base_numa.cpus[k])) return k;
+    }
+    return -1;
+}
+
+#endif // TINY_CBASE_NUMA
+
+// Serial encode with the codec selected by mode_flags (as in BASE_GetEncodeLen)
+static bool base_encode_any(const uint8_t *in, size_t in_len, char *out, size_t *out_len, int mode_flags) {
+#if TINY_CBASE_ENABLE_BASE16
+    if (mode_flags & (BASE16_UPPER | BASE16_LOWER)) return BASE16_Encode(in, in_len, out, out_len, mode_flags);
+#endif
+#if TINY_CBASE_ENABLE_BASE32
+    if (mode_flags & BASE32_ENC) return BASE32_Encode(in, in_len, out, out_len, mode_flags);
+#endif
+#if TINY_CBASE_ENABLE_BASE58
+    if (mode_flags & BASE58_ENC) return BASE58_Encode(in, in_len, out, out_len);
+#endif
+#if TINY_CBASE_ENABLE_BASE64
+    if (mode_flags & (BASE64_STD_ENC | BASE64_URL_ENC | BASE64_NOPAD_ENC)) return BASE64_Encode(in, in_len, out, out_len, mode_flags);
+#endif
+#if TINY_CBASE_ENABLE_BASE85
+    if (mode_flags & (BASE85_STD_ENC | BASE85_EXT_ENC | BASE85_Z85_ENC)) return BASE85_Encode(in, in_len, out, out_len, mode_flags);
+#endif
+    return false;
+}
+
+// Whole job on the calling thread
+static bool base_job_serial(BASE_Job *job, bool decode) {
+    if (decode) {
+        job->ok = BASE_DecodeEx((const char *)job->in, job->in_len, (uint8_t *)job->out, &job->out_len, job->mode_flags, &job->err);
+    } else {
+        job->err.reason = BASE_ERR_NONE;
+        job->err.offset = 0;
+        job->err.ch = 0;
+        job->ok = base_encode_any((const uint8_t *)job->in, job->in_len, (char *)job->out, &job->out_len, job->mode_flags);
+    }
+    return job->ok;
+}
+
+#if TINY_CBASE_FDIO || TINY_CBASE_ENABLE_BASE16 || TINY_CBASE_ENABLE_BASE32 || TINY_CBASE_ENABLE_BASE64
+// fn without writing past the output it reports (the encoders' '\0', wide
+// vector stores): the last BASE_PAR_TAIL_QUANTA quanta of in, or a final
+// partial quantum, go through a stack buffer. Error offsets are relative to in.
+static bool base_chunk_contained(base_chunk_fn fn, size_t in_q, const uint8_t *in, size_t len, uint8_t *out, size_t *out_len,
+                                 int mode_flags, BASE_Error *err) {
+    uint8_t stage[BASE_PAR_TAIL_QUANTA * 8 + 64];
+    size_t tail = in_q * BASE_PAR_TAIL_QUANTA, n = 0, tail_n = 0;
+    if (tail > len) tail = len;
+    size_t body = len - tail;
+
+    if (body && !fn(in, body, out, &n, mode_flags, err)) return false;
+    if (!fn(in + body, tail, stage, &tail_n, mode_flags, err)) {
+        if (err) err->offset += body;
+        return false;
+    }
+    memcpy(out + n, stage, tail_n);
+    *out_len = n + tail_n;
+    return true;
+}
+
+#endif
+
+#if TINY_CBASE_ENABLE_BASE16 || TINY_CBASE_ENABLE_BASE32 || TINY_CBASE_ENABLE_BASE64
+// --- Range decode ---
+
+// Bytes [off, off + len) of an unwrapped stream of eq-char, dq-byte quanta,
+// decoding only the quanta that cover them: the partial first and last ones
+// through a stack buffer, those in between straight into out
+static bool base_decode_range(base_chunk_fn fn, size_t eq, size_t dq, const char *enc, size_t enc_len, size_t off, size_t len,
+                              uint8_t *out, int mode_flags) {
+    const uint8_t *in = (const uint8_t *)enc;
+    uint8_t stage[16];
+    size_t n;
+
+    if (!enc || enc_len == 0 || !out || len == 0 || off > SIZE_MAX - len) return false;
+
+    size_t first = off / dq, last = (off + len - 1) / dq;
+    if (last >= (enc_len + eq - 1) / eq) return false; // past the last quantum
+    size_t skip = off - first * dq;
+
+    // Padding may only end the range's last quantum
+    size_t q_len = enc_len - first * eq < eq ? enc_len - first * eq : eq;
+    if (!fn(in + first * eq, q_len, stage, &n, mode_flags, NULL) || n <= skip || (first != last && n != dq)) return false;
+    size_t done = n - skip < len ? n - skip : len;
+    memcpy(out, stage + skip, done);
+    if (first == last) return done == len;
+
+    size_t mid = last - first - 1;
+    if (mid) {
+        if (!base_chunk_contained(fn, eq, in + (first + 1) * eq, mid * eq, out + done, &n, mode_flags, NULL) || n != mid * dq) return false;
+        done += n;
+    }
+
+    q_len = enc_len - last * eq < eq ? enc_len - last * eq : eq;
+    if (!fn(in + last * eq, q_len, stage, &n, mode_flags, NULL) || n < len - done) return false;
+    memcpy(out + done, stage, len - done);
+    return true;
+}
+
+#if TINY_CBASE_ENABLE_BASE16
+bool BASE16_DecodeRange(const char *encoded_data, size_t encoded_len, size_t byte_off, size_t byte_len, uint8_t *out_decoded) {
+    return base_decode_range(base16_decode_chunk, 2, 1, encoded_data, encoded_len, byte_off, byte_len, out_decoded, 0);
+}
+#endif
+
+#if TINY_CBASE_ENABLE_BASE32
+bool BASE32_DecodeRange(const char *encoded_data, size_t encoded_len, size_t byte_off, size_t byte_len, uint8_t *out_decoded, int mode_flags) {
+    return base_decode_range(base32_decode_chunk, 8, 5, encoded_data, encoded_len, byte_off, byte_len, out_decoded, mode_flags);
+}
+#endif
+
+#if TINY_CBASE_ENABLE_BASE64
+bool BASE64_DecodeRange(const char *encoded_data, size_t encoded_len, size_t byte_off, size_t byte_len, uint8_t *out_decoded, int mode_flags) {
+    // Forgiving input may hold whitespace: offsets no longer map linearly
+    if (mode_flags & BASE64_FORGIVING_DEC) return false;
+    return base_decode_range(base64_decode_chunk, 4, 3, encoded_data, encoded_len, byte_off, byte_len, out_decoded, mode_flags);
+}
+#endif
+
+#if TINY_CBASE_ENABLE_BASE64
+// --- Line index for wrapped Base64 ---
+static FORCE_INLINE bool base64_is_eol(char c) {
+    return c == '\n' || c == '\r';
+}
+
+// Offset of the first '\n' or '\r' at or after from, or len if there is none
+static size_t base64_find_eol(const char *text, size_t from, size_t len) {
+    size_t i = from;
+#if TINY_CBASE_SSE2
+    const __m128i lf = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    for (; len - i >= 16; i += 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)(text + i));
+        uint32_t m = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, lf), _mm_cmpeq_epi8(v, cr)));
+        if (m) return i + base_ctz32(m);
+    }
+#endif
+    for (; i < len; i++) {
+        if (base64_is_eol(text[i])) break;
+    }
+    return i;
+}
+
+// Cursor over the Base64 chars of a wrapped body, line breaks skipped
+typedef struct {
+    const char *text;
+    size_t len;
+    size_t pos;
+    size_t line_end;
+} base64_lines;
+
+// Chars left on the current line, moving to the next one when it is used up; 0 at the end
+static size_t base64_lines_avail(base64_lines *r) {
+    while (r->pos == r->line_end && r->pos < r->len) {
+        while (r->pos < r->len && base64_is_eol(r->text[r->pos])) r->pos++;
+        r->line_end = base64_find_eol(r->text, r->pos, r->len);
+    }
+    return r->line_end - r->pos;
+}
+
+bool BASE64_IndexLines(const char *text, size_t text_len, int mode_flags, BASE64_LineMark *marks, size_t max_marks, BASE64_LineIndex *out_index) {
+    if (!text || !marks || !out_index || max_marks == 0 || (mode_flags & BASE64_FORGIVING_DEC)) return false;
+
+    base64_lines r = { text, text_len, 0, 0 };
+    size_t chars = 0, count = 0, next = 0;
+
+    for (size_t avail; (avail = base64_lines_avail(&r)) != 0; r.pos += avail) {
+        // A line start where a quantum starts, once past the next checkpoint
+        size_t dec = chars / 4 * 3;
+        if (chars % 4 == 0 && dec >= next) {
+            if (count == max_marks) return false;
+            marks[count].enc_off = r.pos;
+            marks[count].dec_off = dec;
+            count++;
+            next = dec + BASE64_INDEX_STEP;
+        }
+        chars += avail;
+    }
+
+    // Padding at the very end takes no bytes (a break may split "==")
+    size_t end = text_len, pads = 0;
+    while (pads < 2) {
+        while (end && base64_is_eol(text[end - 1])) end--;
+        if (!end || text[end - 1] != '=') break;
+        end--;
+        pads++;
+    }
+
+    out_index->marks = marks;
+    out_index->count = count;
+    out_index->dec_len = (chars - pads) * 3 / 4;
+    out_index->mode_flags = mode_flags;
+    return true;
+}
+
+bool BASE64_DecodeRangeIndexed(const char *text, size_t text_len, const BASE64_LineIndex *index, size_t byte_off, size_t byte_len, uint8_t *out_decoded) {
+    if (!text || !index || !index->count || !out_decoded || byte_len == 0) return false;
+    if (byte_off > index->dec_len || byte_len > index->dec_len - byte_off) return false;
+
+    // Last checkpoint at or before the range
+    size_t lo = 0, hi = index->count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (index->marks[mid].dec_off <= byte_off) lo = mid;
+        else hi = mid;
+    }
+    const BASE64_LineMark *mark = &index->marks[lo];
+    if (mark->enc_off > text_len) return false;
+
+    // Walk line by line to the quantum holding byte_off
+    base64_lines r = { text, text_len, mark->enc_off, mark->enc_off };
+    size_t skip_chars = (byte_off - mark->dec_off) / 3 * 4;
+    while (skip_chars) {
+        size_t avail = base64_lines_avail(&r);
+        if (avail == 0) return false;
+        size_t step = avail < skip_chars ? avail : skip_chars;
+        r.pos += step;
+        skip_chars -= step;
+    }
+
+    const int mode_flags = index->mode_flags;
+    size_t skip = byte_off % 3, need = byte_len, n;
+    uint8_t *out = out_decoded, stage[16];
+    char quad[4];
+    size_t quad_len = 0;
+
+    while (need) {
+        size_t avail = base64_lines_avail(&r);
+
+        // Whole quanta on this line go straight to the output
+        if (quad_len == 0 && skip == 0 && need >= 3 && avail >= 4) {
+            size_t q = avail / 4 < need / 3 ? avail / 4 : need / 3;
+            if (!base_chunk_contained(base64_decode_chunk, 4, (const uint8_t *)text + r.pos, q * 4, out, &n, mode_flags, NULL) || n != q * 3) return false;
+            out += n;
+            need -= n;
+            r.pos += q * 4;
+            continue;
+        }
+
+        // A quantum split by a line break, or a partial one at either end of the range
+        if (avail) {
+            quad[quad_len++] = text[r.pos++];
+            if (quad_len < 4) continue;
+        } else if (quad_len == 0) {
+            return false;
+        }
+        if (!base64_decode_chunk((const uint8_t *)quad, quad_len, stage, &n, mode_flags, NULL) || n <= skip) return false;
+        size_t take = n - skip < need ? n - skip : need;
+        memcpy(out, stage + skip, take);
+        out += take;
+        need -= take;
+        skip = 0;
+        quad_len = 0;
+        if (need && (n < 3 || !avail)) return false; // padding or the end inside the range
+    }
+    return true;
+}
+#endif
+#endif
+
+#if TINY_CBASE_FDIO
+// --- Chunked coding ---
+
+// A stream coded piece by piece, cut anywhere: the partial quantum at the end
+// of a piece is carried into the next one and flushed on the last, so the
+// outputs concatenate to the one-shot result. Codecs as in base_par_codec.
+typedef struct {
+    base_chunk_fn fn;
+    size_t in_q, out_q;
+    int mode_flags;
+    uint8_t carry[8];      // partial quantum left by the previous piece
+    size_t carry_len;
+    size_t offset;         // stream bytes coded so far
+    bool failed;
+    BASE_Error err;        // first failure, offset from the start of the stream
+} base_coder;
+
+static void base_coder_reset(base_coder *c) {
+    c->carry_len = 0;
+    c->offset = 0;
+    c->failed = false;
+    c->err.reason = BASE_ERR_NONE;
+    c->err.offset = 0;
+    c->err.ch = 0;
+}
+
+static bool base_coder_init(base_coder *c, int mode_flags, bool decode) {
+    if (!base_par_codec(mode_flags, !decode, &c->fn, &c->in_q, &c->out_q)) return false;
+    c->mode_flags = mode_flags;
+    base_coder_reset(c);
+    return true;
+}
+
+// Output bound for a piece of in_len bytes
+static size_t base_coder_out_len(const base_coder *c, size_t in_len) {
+    // Carried bytes complete one more quantum; +1 for the encoders' '\0'
+    return ((in_len + c->in_q - 1) / c->in_q + 1) * c->out_q + 1;
+}
+
+// Codes len stream bytes into out; a failure is recorded with its stream offset
+static bool base_coder_code(base_coder *c, const uint8_t *in, size_t len, uint8_t *out, size_t *n) {
+    BASE_Error err = { BASE_ERR_NONE, 0, 0 };
+    *n = 0;
+    if (base_chunk_contained(c->fn, c->in_q, in, len, out, n, c->mode_flags, &err)) {
+        c->offset += len;
+        return true;
+    }
+    if (err.reason == BASE_ERR_NONE) {
+        // Encoders only fail on a partial last quantum they cannot pad (Z85)
+        err.reason = BASE_ERR_BAD_LENGTH;
+        err.offset = len;
+    }
+    err.offset += c->offset;
+    c->err = err;
+    c->failed = true;
+    return false;
+}
+
+// Next piece; false from the first failure of the stream on
+static bool base_coder_run(base_coder *c, const uint8_t *in, size_t len, bool last, uint8_t *out, size_t *out_len) {
+    size_t n = 0, piece;
+
+    *out_len = 0;
+    if (c->failed) return false;
+
+    // Complete the quantum the previous piece left off
+    if (c->carry_len) {
+        size_t take = c->in_q - c->carry_len;
+        if (take > len) take = len;
+        memcpy(c->carry + c->carry_len, in, take);
+        c->carry_len += take;
+        in += take;
+        len -= take;
+        if (c->carry_len == c->in_q) {
+            c->carry_len = 0;
+            if (!base_coder_code(c, c->carry, c->in_q, out, &piece)) return false;
+            n += piece;
+        }
+    }
+
+    size_t body = len / c->in_q * c->in_q;
+    if (body) {
+        if (!base_coder_code(c, in, body, out + n, &piece)) return false;
+        n += piece;
+    }
+    memcpy(c->carry + c->carry_len, in + body, len - body);
+    c->carry_len += len - body;
+
+    if (last && c->carry_len) {
+        if (!base_coder_code(c, c->carry, c->carry_len, out + n, &piece)) return false;
+        n += piece;
+        c->carry_len = 0;
+    }
+    *out_len = n;
+    return true;
+}
+#endif // TINY_CBASE_FDIO
+
+#if TINY_CBASE_THREADS
+
+// --- Work-stealing pool ---
+//
+// Each worker owns a Chase-Lev deque (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models", PPoPP 2013): the owner pushes and
+// takes at the bottom, idle workers steal from the top. Batches enter through
+// one locked injection queue per NUMA node. A task halves itself while it is
+// worth sharing and pushes the other half where idle workers can steal it.
+
+#define BASE_POOL_DEQUE 1024               // tasks per deque, a power of two
+#define BASE_POOL_GRAIN ((size_t)64 << 10) // work per leaf task, in input bytes
+#define BASE_POOL_MAX_WORKERS 255
+#define BASE_POOL_MAX_NODES 64
+
+struct base_batch;
+
+typedef struct {
+    struct base_batch *batch;
+    size_t first, count; // jobs own[first .. first + count) of the batch
+    size_t lo, hi;       // with `range`: input range of job `first`
+    bool range;
+    bool heap;           // made by a split, freed once taken
+} base_task;
+
+typedef struct {
+    _Atomic int64_t top;
+    char pad0[56]; // thieves and owner on separate cache lines
+    _Atomic int64_t bottom;
+    char pad1[56];
+    _Atomic(base_task *) slot[BASE_POOL_DEQUE];
+} base_deque;
+
+typedef struct {
+    base_deque deque;
+    int node;       // injection queue served first, and CPUs pinned to
+    bool running;
+    pthread_t thread;
+} base_pool_worker;
+
+typedef struct {
+    base_task **ring;
+    size_t head, len, cap;
+} base_inject;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t work; // idle workers
+    pthread_cond_t done; // threads waiting for their batch
+    base_pool_worker *workers;
+    size_t nworkers;
+    size_t nrunning; // workers whose thread started
+    int nodes;
+    base_inject inject[BASE_POOL_MAX_NODES];
+    atomic_long pending; // tasks queued anywhere
+    atomic_long idle;    // workers going to sleep
+    atomic_bool started;
+    bool stop;
+} base_pool = { .lock = PTHREAD_MUTEX_INITIALIZER, .work = PTHREAD_COND_INITIALIZER, .done = PTHREAD_COND_INITIALIZER };
+
+static _Thread_local base_pool_worker *base_pool_self;
+static _Thread_local unsigned base_pool_seed;
+
+// Owner only. False when full; the caller then runs the task itself.
+static bool base_deque_push(base_deque *d, base_task *t) {
+    int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed);
+    int64_t top = atomic_load_explicit(&d->top, memory_order_acquire);
+    if (b - top >= BASE_POOL_DEQUE) return false;
+
+    atomic_store_explicit(&d->slot[b & (BASE_POOL_DEQUE - 1)], t, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    return true;
+}
+
+// Owner only: newest task, or NULL
+static base_task *base_deque_take(base_deque *d) {
+    int64_t b = atomic_load_explicit(&d->bottom, memory_order_relaxed) - 1;
+    atomic_store_explicit(&d->bottom, b, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t t = atomic_load_explicit(&d->top, memory_order_relaxed);
+    base_task *x = NULL;
+
+    if (t <= b) {
+        x = atomic_load_explicit(&d->slot[b & (BASE_POOL_DEQUE - 1)], memory_order_relaxed);
+        if (t == b) {
+            // Last task: race the thieves for it
+            if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) x = NULL;
+            atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+        }
+    } else {
+        atomic_store_explicit(&d->bottom, b + 1, memory_order_relaxed);
+    }
+    return x;
+}
+
+// Any thread: oldest task, or NULL (empty, or lost a race)
+static base_task *base_deque_steal(base_deque *d) {
+    int64_t t = atomic_load_explicit(&d->top, memory_order_acquire);
+    atomic_thread_fence(memory_order_seq_cst);
+    int64_t b = atomic_load_explicit(&d->bottom, memory_order_acquire);
+    if (t >= b) return NULL;
+
+    base_task *x = atomic_load_explicit(&d->slot[t & (BASE_POOL_DEQUE - 1)], memory_order_relaxed);
+    if (!atomic_compare_exchange_strong_explicit(&d->top, &t, t + 1, memory_order_seq_cst, memory_order_relaxed)) return NULL;
+    return x;
+}
+
+// Under the pool lock: room for `extra` more tasks in q
+static bool base_inject_reserve(base_inject *q, size_t extra) {
+    if (q->cap - q->len >= extra) return true;
+
+    size_t cap = q->cap ? q->cap : 64;
+    while (cap - q->len < extra) cap *= 2;
+    base_task **ring = (base_task **)malloc(cap * sizeof(*ring));
+    if (!ring) return false;
+
+    for (size_t i = 0; i < q->len; i++) ring[i] = q->ring[(q->head + i) % q->cap];
+    free(q->ring);
+    q->ring = ring;
+    q->head = 0;
+    q->cap = cap;
+    return true;
+}
+
+static base_task *base_inject_pop(int node) {
+    base_task *t = NULL;
+    pthread_mutex_lock(&base_pool.lock);
+    base_inject *q = &base_pool.inject[node];
+    if (q->len) {
+        t = q->ring[q->head];
+        q->head = (q->head + 1) % q->cap;
+        q->len--;
+    }
+    pthread_mutex_unlock(&base_pool.lock);
+    return t;
+}
+
+// Next task for a thread serving `node`: own deque, the node's injection
+// queue, a steal (same node first), then the other nodes' queues
+static base_task *base_pool_find(base_pool_worker *self, int node) {
+    base_task *t = NULL;
+
+    if (atomic_load(&base_pool.pending) <= 0) return NULL;
+    if (self) t = base_deque_take(&self->deque);
+    if (!t) t = base_inject_pop(node);
+
+    size_t n = base_pool.nworkers, start = base_pool_seed++;
+    for (int pass = 0; !t && pass < 2; pass++) {
+        for (size_t k = 0; k < n && !t; k++) {
+            base_pool_worker *w = &base_pool.workers[(start + k) % n];
+            if (w == self || (w->node == node) != (pass == 0)) continue;
+            t = base_deque_steal(&w->deque);
+        }
+    }
+    for (int k = 0; !t && k < base_pool.nodes; k++) {
+        if (k != node) t = base_inject_pop(k);
+    }
+
+    if (t) atomic_fetch_sub(&base_pool.pending, 1);
+    return t;
+}
+
+// Offers t to idle workers; false if the deque is full
+static bool base_pool_push(base_pool_worker *self, base_task *t) {
+    atomic_fetch_add(&base_pool.pending, 1);
+    if (!base_deque_push(&self->deque, t)) {
+        atomic_fetch_sub(&base_pool.pending, 1);
+        return false;
+    }
+    if (atomic_load(&base_pool.idle) > 0) {
+        pthread_mutex_lock(&base_pool.lock);
+        pthread_cond_signal(&base_pool.work);
+        pthread_mutex_unlock(&base_pool.lock);
+    }
+    return true;
+}
+
+// Node the calling thread runs on, as an injection queue index
+static int base_pool_current_node(void) {
+#if TINY_CBASE_NUMA
+    if (base_pool.nodes > 1) {
+        int k = base_numa_current_slot();
+        if (k >= 0 && k < base_pool.nodes) return k;
+    }
+#endif
+    return 0;
+}
+
+// --- Batches ---
+
+typedef struct {
+    base_chunk_fn fn;        // splittable codec, NULL = whole jobs only
+    size_t in_q, out_q;
+    bool placed;             // cut into pieces by the submitter
+    atomic_size_t remaining; // input bytes not coded yet
+    atomic_bool redo;        // a range failed or came out short: rerun serially
+    size_t last_lo, last_n;  // range ending the input, and its output
+} base_job_state;
+
+typedef struct base_batch {
+    BASE_Job *jobs;
+    base_job_state *state;
+    size_t *own;             // jobs not cut up front, in order
+    uint64_t *cost;          // prefix sums of their estimated work, 64-bit even where size_t is not
+    bool decode;
+    atomic_size_t remaining; // unfinished jobs
+    atomic_bool done;
+    BASE_JobDone on_done;    // async batches: reported here, then freed
+    void *ctx;
+    base_task *tasks;        // queued by the submitter
+    int *nodes;              // injection queue of each
+    size_t ntasks;
+} base_batch;
+
+static void base_batch_free(base_batch *b) {
+    if (!b) return;
+    free(b->state);
+    free(b->own);
+    free(b->cost);
+    free(b->tasks);
+    free(b->nodes);
+    free(b);
+}
+
+// Rough work of a job, in Base64 bytes; fixed per-job overhead included
+static uint64_t base_job_cost(const BASE_Job *job, const base_job_state *st) {
+    uint64_t len = job->in_len;
+    if (st->fn) return len + 64;
+#if TINY_CBASE_ENABLE_BASE58
+    if (job->mode_flags & (BASE58_ENC | BASE58_DEC)) {
+        // Quadratic; capped so the prefix sums cannot overflow
+        return len < ((uint64_t)1 << 20) ? len * len / 16 + 64 : (uint64_t)1 << 36;
+    }
+#endif
+    return (len < ((uint64_t)1 << 40) ? len * 2 : (uint64_t)1 << 41) + 64;
+}
+
+// Last access to b by anyone but its submitter (or, async, the thread that
+// finishes it)
+static void base_batch_job_done(base_batch *b) {
+    if (atomic_fetch_sub(&b->remaining, 1) != 1) return;
+    if (b->on_done) {
+        b->on_done(b->jobs, b->ctx);
+        base_batch_free(b);
+        return;
+    }
+    pthread_mutex_lock(&base_pool.lock);
+    atomic_store(&b->done, true);
+    pthread_cond_broadcast(&base_pool.done);
+    pthread_mutex_unlock(&base_pool.lock);
+}
+
+// Codes input [lo, hi) of job j in place. Whatever the codec writes past its
+// output (the encoders' '\0', wide vector stores) must not reach the next
+// range, so the last BASE_PAR_TAIL_QUANTA quanta go through a stack buffer;
+// the range that ends the input carries the padding and the '\0' and runs in
+// place.
+static void base_job_range(base_batch *b, size_t j, size_t lo, size_t hi) {
+    BASE_Job *job = &b->jobs[j];
+    base_job_state *st = &b->state[j];
+    const uint8_t *in = (const uint8_t *)job->in;
+    uint8_t *out = (uint8_t *)job->out + lo / st->in_q * st->out_q;
+    size_t n = 0;
+    bool ok;
+
+    if (hi == job->in_len) {
+        ok = st->fn(in + lo, hi - lo, out, &n, job->mode_flags, NULL);
+        st->last_lo = lo;
+        st->last_n = n;
+    } else {
+        ok = base_chunk_contained(st->fn, st->in_q, in + lo, hi - lo, out, &n, job->mode_flags, NULL);
+        // Padding inside the input leaves a gap; rare enough to redo serially
+        ok = ok && n == (hi - lo) / st->in_q * st->out_q;
+    }
+    if (!ok) atomic_store(&st->redo, true);
+
+    if (atomic_fetch_sub(&st->remaining, hi - lo) != hi - lo) return;
+
+    // Last range of the job
+    if (atomic_load(&st->redo)) {
+        base_job_serial(job, b->decode);
+    } else {
+        job->out_len = st->last_lo / st->in_q * st->out_q + st->last_n;
+        job->ok = true;
+        job->err.reason = BASE_ERR_NONE;
+        job->err.offset = 0;
+        job->err.ch = 0;
+    }
+    base_batch_job_done(b);
+}
+
+static base_task *base_task_new(base_batch *b, size_t first, size_t count, size_t lo, size_t hi, bool range) {
+    base_task *t = (base_task *)malloc(sizeof(*t));
+    if (t) {
+        t->batch = b;
+        t->first = first;
+        t->count = count;
+        t->lo = lo;
+        t->hi = hi;
+        t->range = range;
+        t->heap = true;
+    }
+    return t;
+}
+
+// Job index splitting [lo, hi) into halves of about equal work
+static size_t base_batch_split(const base_batch *b, size_t lo, size_t hi) {
+    uint64_t half = b->cost[lo] + (b->cost[hi] - b->cost[lo]) / 2;
+    size_t l = lo + 1, h = hi - 1;
+    while (l < h) {
+        size_t m = l + (h - l) / 2;
+        if (b->cost[m] < half) l = m + 1;
+        else h = m;
+    }
+    return l;
+}
+
+static void base_task_run(base_pool_worker *self, base_task *task) {
+    base_task t = *task;
+    base_batch *b = t.batch;
+    if (task->heap) free(task);
+
+    // Only workers split: the halves go to their deque
+    while (!t.range && t.count > 1 && self && b->cost[t.first + t.count] - b->cost[t.first] > BASE_POOL_GRAIN) {
+        size_t mid = base_batch_split(b, t.first, t.first + t.count);
+        base_task *right = base_task_new(b, mid, t.first + t.count - mid, 0, 0, false);
+        if (!right || !base_pool_push(self, right)) {
+            free(right);
+            break;
+        }
+        t.count = mid - t.first;
+    }
+
+    if (!t.range) {
+        size_t j = b->own[t.first];
+        if (t.count == 1 && b->state[j].fn && self && b->jobs[j].in_len > BASE_POOL_GRAIN) {
+            // One big job left: split its input instead
+            t.range = true;
+            t.first = j;
+            t.lo = 0;
+            t.hi = b->jobs[j].in_len;
+        } else {
+            // b is not read after the last job: that one may finish the batch
+            for (size_t i = t.first, end = t.first + t.count; i < end; i++) {
+                base_job_serial(&b->jobs[b->own[i]], b->decode);
+                base_batch_job_done(b);
+            }
+            return;
+        }
+    }
+
+    // Input range of one job: halve at page-aligned quanta
+    size_t granule = b->state[t.first].in_q * 4096;
+    while (self && t.hi - t.lo > BASE_POOL_GRAIN) {
+        size_t mid = t.lo + (t.hi - t.lo) / 2 / granule * granule;
+        if (mid == t.lo) break;
+        base_task *right = base_task_new(b, t.first, 1, mid, t.hi, true);
+        if (!right || !base_pool_push(self, right)) {
+            free(right);
+            break;
+        }
+        t.hi = mid;
+    }
+    base_job_range(b, t.first, t.lo, t.hi);
+}
+
+static void *base_pool_main(void *arg) {
+    base_pool_worker *self = (base_pool_worker *)arg;
+    base_pool_self = self;
+    base_pool_seed = (unsigned)(self - base_pool.workers);
+#if TINY_CBASE_NUMA
+    if (base_pool.nodes > 1) pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &base_numa.cpus[self->node]);
+#endif
+
+    for (;;) {
+        base_task *t = base_pool_find(self, self->node);
+        if (t) {
+            base_task_run(self, t);
+            continue;
+        }
+
+        pthread_mutex_lock(&base_pool.lock);
+        atomic_fetch_add(&base_pool.idle, 1);
+        while (!base_pool.stop && atomic_load(&base_pool.pending) <= 0) pthread_cond_wait(&base_pool.work, &base_pool.lock);
+        atomic_fetch_sub(&base_pool.idle, 1);
+        bool stop = base_pool.stop;
+        pthread_mutex_unlock(&base_pool.lock);
+        if (stop) return NULL;
+    }
+}
+
+static size_t base_par_cpus(void) {
+#if TINY_CBASE_NUMA
+    cpu_set_t set;
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) return (size_t)CPU_COUNT(&set);
+#endif
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (size_t)n : 1;
+}
+
+bool BASE_PoolStart(size_t workers) {
+    pthread_mutex_lock(&base_pool.lock);
+    if (atomic_load(&base_pool.started)) {
+        pthread_mutex_unlock(&base_pool.lock);
+        return true;
+    }
+
+    // The submitting thread helps; one worker at least, for the async calls
+    if (workers == 0) workers = base_par_cpus() > 1 ? base_par_cpus() - 1 : 1;
+    if (workers > BASE_POOL_MAX_WORKERS) workers = BASE_POOL_MAX_WORKERS;
+
+    base_pool.nodes = 1;
+#if TINY_CBASE_NUMA
+    pthread_once(&base_numa_once, base_numa_load);
+    if (base_numa.count >= 2) base_pool.nodes = base_numa.count;
+#endif
+
+    base_pool.workers = workers ? (base_pool_worker *)calloc(workers, sizeof(*base_pool.workers)) : NULL;
+    base_pool.nworkers = base_pool.workers ? workers : 0;
+
+#if TINY_CBASE_NUMA
+    // Workers spread over the nodes in proportion to their CPUs: worker w
+    // takes the node of CPU number w * total / workers, counted across nodes
+    if (base_pool.nodes > 1) {
+        size_t cpus[BASE_NUMA_MAX_NODES], total = 0;
+        for (int k = 0; k < base_pool.nodes; k++) total += cpus[k] = (size_t)CPU_COUNT(&base_numa.cpus[k]);
+        for (size_t w = 0, k = 0, seen = cpus[0]; w < base_pool.nworkers; w++) {
+            while (w * total / base_pool.nworkers >= seen) seen += cpus[++k];
+            base_pool.workers[w].node = (int)k;
+        }
+    }
+#endif
+
+    // Threads that fail to start leave an empty deque behind; nothing is pushed there
+    for (size_t w = 0; w < base_pool.nworkers; w++) {
+        base_pool_worker *worker = &base_pool.workers[w];
+        worker->running = pthread_create(&worker->thread, NULL, base_pool_main, worker) == 0;
+        base_pool.nrunning += worker->running;
+    }
+
+    atomic_store(&base_pool.started, true);
+    pthread_mutex_unlock(&base_pool.lock);
+    return true;
+}
+
+void BASE_PoolStop(void) {
+    pthread_mutex_lock(&base_pool.lock);
+    if (!atomic_load(&base_pool.started)) {
+        pthread_mutex_unlock(&base_pool.lock);
+        return;
+    }
+    base_pool.stop = true;
+    pthread_cond_broadcast(&base_pool.work);
+    pthread_mutex_unlock(&base_pool.lock);
+
+    for (size_t w = 0; w < base_pool.nworkers; w++) {
+        if (base_pool.workers[w].running) pthread_join(base_pool.workers[w].thread, NULL);
+    }
+
+    pthread_mutex_lock(&base_pool.lock);
+    free(base_pool.workers);
+    base_pool.workers = NULL;
+    base_pool.nworkers = 0;
+    base_pool.nrunning = 0;
+    for (int k = 0; k < BASE_POOL_MAX_NODES; k++) {
+        free(base_pool.inject[k].ring);
+        memset(&base_pool.inject[k], 0, sizeof(base_pool.inject[k]));
+    }
+    base_pool.stop = false;
+    atomic_store(&base_pool.started, false);
+    pthread_mutex_unlock(&base_pool.lock);
+}
+
+// Injection queue of each piece: the node holding its first input page
+static void base_pool_piece_nodes(const void **pages, int *nodes, size_t count) {
+    for (size_t i = 0; i < count; i++) nodes[i] = (int)(i % (size_t)base_pool.nodes);
+#if TINY_CBASE_NUMA
+    if (base_pool.nodes > 1) {
+        int *slots = (int *)malloc(count * sizeof(*slots));
+        if (!slots) return;
+        base_numa_page_slots(pages, slots, count);
+        for (size_t i = 0; i < count; i++) {
+            if (slots[i] >= 0 && slots[i] < base_pool.nodes) nodes[i] = slots[i];
+        }
+        free(slots);
+    }
+#else
+    (void)pages;
+#endif
+}
+
+// Sets up a batch: large splittable jobs cut into up to `pieces` pieces, each
+// to be queued on the node holding its input, and one task over all the other
+// jobs. NULL if the bookkeeping could not be allocated.
+static base_batch *base_batch_new(BASE_Job *jobs, size_t n, bool decode, size_t pieces) {
+    base_batch *b = (base_batch *)calloc(1, sizeof(*b));
+    if (!b) return NULL;
+
+    b->jobs = jobs;
+    b->decode = decode;
+    atomic_init(&b->remaining, n);
+    atomic_init(&b->done, false);
+    b->state = (base_job_state *)calloc(n, sizeof(*b->state));
+    b->own = (size_t *)malloc(n * sizeof(*b->own));
+    b->cost = (uint64_t *)malloc((n + 1) * sizeof(*b->cost));
+    if (!b->state || !b->own || !b->cost) goto fail;
+
+    size_t nown = 0, ntasks = 0;
+    b->cost[0] = 0;
+    for (size_t j = 0; j < n; j++) {
+        base_job_state *st = &b->state[j];
+        if (base_par_codec(jobs[j].mode_flags, !decode, &st->fn, &st->in_q, &st->out_q)) {
+            size_t k = jobs[j].in_len / BASE_PAR_MIN_RANGE;
+            st->placed = pieces >= 2 && k >= 2;
+            if (st->placed) ntasks += k < pieces ? k : pieces;
+        }
+        atomic_init(&st->remaining, jobs[j].in_len);
+        atomic_init(&st->redo, false);
+        if (!st->placed) {
+            b->own[nown] = j;
+            b->cost[nown + 1] = b->cost[nown] + base_job_cost(&jobs[j], st);
+            nown++;
+        }
+    }
+    ntasks += nown > 0;
+
+    const void **pages = (const void **)malloc(ntasks * sizeof(*pages));
+    b->tasks = (base_task *)calloc(ntasks, sizeof(*b->tasks));
+    b->nodes = (int *)malloc(ntasks * sizeof(*b->nodes));
+    if (!pages || !b->tasks || !b->nodes) {
+        free(pages);
+        goto fail;
+    }
+
+    size_t t = 0;
+    for (size_t j = 0; j < n; j++) {
+        base_job_state *st = &b->state[j];
+        if (!st->placed) continue;
+
+        size_t k = jobs[j].in_len / BASE_PAR_MIN_RANGE, granule = st->in_q * 4096;
+        if (k > pieces) k = pieces;
+        size_t piece = (jobs[j].in_len / k + granule - 1) / granule * granule;
+        for (size_t lo = 0; lo < jobs[j].in_len; lo += piece, t++) {
+            b->tasks[t].batch = b;
+            b->tasks[t].first = j;
+            b->tasks[t].count = 1;
+            b->tasks[t].lo = lo;
+            b->tasks[t].hi = jobs[j].in_len - lo > piece ? lo + piece : jobs[j].in_len;
+            b->tasks[t].range = true;
+            pages[t] = (const uint8_t *)jobs[j].in + lo;
+        }
+    }
+    base_pool_piece_nodes(pages, b->nodes, t);
+    free(pages);
+    if (nown) {
+        b->tasks[t].batch = b;
+        b->tasks[t].first = 0;
+        b->tasks[t].count = nown;
+        b->nodes[t++] = base_pool_current_node();
+    }
+    b->ntasks = t;
+    return b;
+
+fail:
+    base_batch_free(b);
+    return NULL;
+}
+
+// Queues the batch's tasks; false (nothing queued) if out of memory
+static bool base_batch_submit(base_batch *b) {
+    bool room = true;
+
+    pthread_mutex_lock(&base_pool.lock);
+    for (int k = 0; k < base_pool.nodes && room; k++) room = base_inject_reserve(&base_pool.inject[k], b->ntasks);
+    if (room) {
+        for (size_t i = 0; i < b->ntasks; i++) {
+            base_inject *q = &base_pool.inject[b->nodes[i]];
+            q->ring[(q->head + q->len++) % q->cap] = &b->tasks[i];
+        }
+        atomic_fetch_add(&base_pool.pending, (long)b->ntasks);
+        pthread_cond_broadcast(&base_pool.work);
+    }
+    pthread_mutex_unlock(&base_pool.lock);
+    return room;
+}
+
+// Helps with queued work until the batch is done, then sleeps on it
+static void base_batch_wait(base_batch *b) {
+    base_pool_worker *self = base_pool_self;
+    int node = self ? self->node : base_pool_current_node();
+
+    while (!atomic_load(&b->done)) {
+        base_task *task = base_pool_find(self, node);
+        if (task) {
+            base_task_run(self, task);
+            continue;
+        }
+        pthread_mutex_lock(&base_pool.lock);
+        while (!atomic_load(&b->done)) pthread_cond_wait(&base_pool.done, &base_pool.lock);
+        pthread_mutex_unlock(&base_pool.lock);
+    }
+}
+
+// Runs a batch on the pool, the calling thread helping. False if it could not
+// be queued (nothing was run).
+static bool base_batch_pool(BASE_Job *jobs, size_t n, bool decode, size_t pieces) {
+    base_batch *b = base_batch_new(jobs, n, decode, pieces);
+    if (!b) return false;
+    if (!base_batch_submit(b)) {
+        base_batch_free(b);
+        return false;
+    }
+    base_batch_wait(b);
+    base_batch_free(b);
+    return true;
+}
+
+// Queues one job whose completion is reported through done on a pool thread.
+// False if it could not be queued (nothing was run).
+static bool base_job_async(BASE_Job *job, bool decode, BASE_JobDone done, void *ctx) {
+    if (!atomic_load(&base_pool.started)) BASE_PoolStart(0);
+    if (!base_pool.nrunning) return false;
+
+    base_batch *b = base_batch_new(job, 1, decode, base_pool.nrunning);
+    if (!b) return false;
+    b->on_done = done;
+    b->ctx = ctx;
+    if (!base_batch_submit(b)) {
+        base_batch_free(b);
+        return false;
+    }
+    return true;
+}
+
+#endif // TINY_CBASE_THREADS
+
+static bool base_batch_run(BASE_Job *jobs, size_t n, bool decode, size_t threads) {
+    if (!jobs || n == 0) return false;
+
+#if TINY_CBASE_THREADS
+    if (!atomic_load(&base_pool.started)) BASE_PoolStart(0);
+
+    // Pieces per large job: `threads`, or one per pool thread
+    size_t pieces = threads ? threads : base_pool.nworkers + 1;
+    bool worth = false;
+    for (size_t j = 0, work = 0; j < n && !worth; j++) {
+        work += jobs[j].in_len;
+        worth = work > BASE_POOL_GRAIN;
+    }
+    if (worth && (pieces >= 2 || base_pool.nworkers) && base_batch_pool(jobs, n, decode, pieces)) {
+        bool ok = true;
+        for (size_t j = 0; j < n; j++) ok &= jobs[j].ok;
+        return ok;
+    }
+#else
+    (void)threads;
+#endif
+
+    bool ok = true;
+    for (size_t j = 0; j < n; j++) ok &= base_job_serial(&jobs[j], decode);
+    return ok;
+}
+
+bool BASE_EncodeBatch(BASE_Job *jobs, size_t n) {
+    return base_batch_run(jobs, n, false, 0);
+}
+
+bool BASE_DecodeBatch(BASE_Job *jobs, size_t n) {
+    return base_batch_run(jobs, n, true, 0);
+}
+
+// Queued: done runs later on a pool thread. Not queued (no threads, out of
+// memory): the job runs here and done is called before returning.
+static bool base_job_offload(BASE_Job *job, bool decode, BASE_JobDone done, void *ctx) {
+    if (!job) return false;
+#if TINY_CBASE_THREADS
+    if (done && base_job_async(job, decode, done, ctx)) return true;
+#endif
+    base_job_serial(job, decode);
+    if (done) done(job, ctx);
+    return false;
+}
+
+bool BASE_EncodeAsync(BASE_Job *job, BASE_JobDone done, void *ctx) {
+    return base_job_offload(job, false, done, ctx);
+}
+
+bool BASE_DecodeAsync(BASE_Job *job, BASE_JobDone done, void *ctx) {
+    return base_job_offload(job, true, done, ctx);
+}
+
+#if !TINY_CBASE_THREADS
+bool BASE_PoolStart(size_t workers) {
+    (void)workers;
+    return false;
+}
+
+void BASE_PoolStop(void) {
+}
+#endif
+
+bool BASE_EncodeParallel(const uint8_t *raw_data, size_t raw_len, char *out_encoded, size_t *out_encoded_len, int mode_flags, size_t threads) {
+    base_chunk_fn fn;
+    size_t in_q, out_q;
+
+    if (!raw_data || !raw_len || !out_encoded || !out_encoded_len) return false;
+    if (!base_par_codec(mode_flags, true, &fn, &in_q, &out_q)) return false;
+    if (threads == 1 || raw_len / BASE_PAR_MIN_RANGE < 2) return fn(raw_data, raw_len, (uint8_t *)out_encoded, out_encoded_len, mode_flags, NULL);
+
+    BASE_Job job = { raw_data, raw_len, out_encoded, 0, mode_flags, false, { BASE_ERR_NONE, 0, 0 } };
+    base_batch_run(&job, 1, false, threads);
+    if (job.ok) *out_encoded_len = job.out_len;
+    return job.ok;
+}
+
+bool BASE_DecodeParallel(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags, size_t threads, BASE_Error *err) {
+    base_chunk_fn fn;
+    size_t in_q, out_q;
+
+    if (!encoded_data || !encoded_len || !out_decoded || !out_decoded_len || threads == 1 ||
+        encoded_len / BASE_PAR_MIN_RANGE < 2 || !base_par_codec(mode_flags, false, &fn, &in_q, &out_q)) {
+        return BASE_DecodeEx(encoded_data, encoded_len, out_decoded, out_decoded_len, mode_flags, err);
+    }
+
+    BASE_Job job = { encoded_data, encoded_len, out_decoded, 0, mode_flags, false, { BASE_ERR_NONE, 0, 0 } };
+    base_batch_run(&job, 1, true, threads);
+    if (job.ok) *out_decoded_len = job.out_len;
+    if (err) *err = job.err;
+    return job.ok;
+}
+
+// --- Pipeline stage ---
+
+#if TINY_CBASE_THREADS
+// Single-producer/single-consumer ring of chunk descriptors. Each side keeps
+// a cached copy of the other's index and reloads it only when the ring looks
+// full (producer) or empty (consumer), so in steady state the two threads
+// touch each other's cache line once per lap, not once per chunk.
+typedef struct {
+    BASE_Chunk *slot;
+    size_t mask;
+    char pad0[48];
+    _Atomic size_t head;   // next slot to pop, written by the consumer
+    size_t tail_seen;
+    char pad1[48];
+    _Atomic size_t tail;   // next slot to fill, written by the producer
+    size_t head_seen;
+    char pad2[48];
+} base_spsc;
+
+static bool base_spsc_init(base_spsc *r, size_t size) {
+    size_t cap = 2;
+    while (cap < size) cap <<= 1;
+    r->slot = (BASE_Chunk *)calloc(cap, sizeof(BASE_Chunk));
+    r->mask = cap - 1;
+    atomic_init(&r->head, 0);
+    atomic_init(&r->tail, 0);
+    r->tail_seen = r->head_seen = 0;
+    return r->slot != NULL;
+}
+
+static bool base_spsc_push(base_spsc *r, const BASE_Chunk *c) {
+    size_t t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (t - r->head_seen > r->mask) {
+        r->head_seen = atomic_load_explicit(&r->head, memory_order_acquire);
+        if (t - r->head_seen > r->mask) return false;
+    }
+    r->slot[t & r->mask] = *c;
+    atomic_store_explicit(&r->tail, t + 1, memory_order_release);
+    return true;
+}
+
+static bool base_spsc_full(base_spsc *r) {
+    size_t t = atomic_load_explicit(&r->tail, memory_order_relaxed);
+    if (t - r->head_seen > r->mask) r->head_seen = atomic_load_explicit(&r->head, memory_order_acquire);
+    return t - r->head_seen > r->mask;
+}
+
+static bool base_spsc_pop(base_spsc *r, BASE_Chunk *c) {
+    size_t h = atomic_load_explicit(&r->head, memory_order_relaxed);
+    if (h == r->tail_seen) {
+        r->tail_seen = atomic_load_explicit(&r->tail, memory_order_acquire);
+        if (h == r->tail_seen) return false;
+    }
+    *c = r->slot[h & r->mask];
+    atomic_store_explicit(&r->head, h + 1, memory_order_release);
+    return true;
+}
+
+struct BASE_Pipe {
+    base_spsc in, out;
+    base_coder coder;      // stage thread only
+};
+
+BASE_Pipe *BASE_PipeCreate(int mode_flags, bool decode, size_t ring_size) {
+    base_coder coder;
+    if (!base_coder_init(&coder, mode_flags, decode)) return NULL;
+
+    BASE_Pipe *p = (BASE_Pipe *)calloc(1, sizeof(*p));
+    if (!p) return NULL;
+    if (!base_spsc_init(&p->in, ring_size) || !base_spsc_init(&p->out, ring_size)) {
+        BASE_PipeDestroy(p);
+        return NULL;
+    }
+    p->coder = coder;
+    return p;
+}
+
+void BASE_PipeDestroy(BASE_Pipe *pipe) {
+    if (!pipe) return;
+    free(pipe->in.slot);
+    free(pipe->out.slot);
+    free(pipe);
+}
+
+size_t BASE_PipeOutLen(const BASE_Pipe *pipe, size_t in_len) {
+    return pipe ? base_coder_out_len(&pipe->coder, in_len) : 0;
+}
+
+bool BASE_PipeSubmit(BASE_Pipe *pipe, const BASE_Chunk *chunk) {
+    if (!pipe || !chunk || (chunk->in_len && (!chunk->in || !chunk->out))) return false;
+    return base_spsc_push(&pipe->in, chunk);
+}
+
+bool BASE_PipeCollect(BASE_Pipe *pipe, BASE_Chunk *chunk) {
+    if (!pipe || !chunk) return false;
+    return base_spsc_pop(&pipe->out, chunk);
+}
+
+static void base_pipe_chunk(BASE_Pipe *p, BASE_Chunk *c) {
+    c->ok = base_coder_run(&p->coder, (const uint8_t *)c->in, c->in_len, c->last, (uint8_t *)c->out, &c->out_len);
+    c->err = p->coder.err;
+    if (c->last) base_coder_reset(&p->coder);
+}
+
+size_t BASE_PipeProcess(BASE_Pipe *pipe, size_t max) {
+    size_t done = 0;
+    BASE_Chunk c;
+
+    if (!pipe) return 0;
+    // Check for room first: a chunk popped from the input ring must go out
+    while (done < max && !base_spsc_full(&pipe->out) && base_spsc_pop(&pipe->in, &c)) {
+        base_pipe_chunk(pipe, &c);
+        base_spsc_push(&pipe->out, &c);
+        done++;
+    }
+    return done;
+}
+#else
+BASE_Pipe *BASE_PipeCreate(int mode_flags, bool decode, size_t ring_size) {
+    (void)mode_flags;
+    (void)decode;
+    (void)ring_size;
+    return NULL;
+}
+
+void BASE_PipeDestroy(BASE_Pipe *pipe) {
+    (void)pipe;
+}
+
+size_t BASE_PipeOutLen(const BASE_Pipe *pipe, size_t in_len) {
+    (void)pipe;
+    (void)in_len;
+    return 0;
+}
+
+bool BASE_PipeSubmit(BASE_Pipe *pipe, const BASE_Chunk *chunk) {
+    (void)pipe;
+    (void)chunk;
+    return false;
+}
+
+size_t BASE_PipeProcess(BASE_Pipe *pipe, size_t max) {
+    (void)pipe;
+    (void)max;
+    return 0;
+}
+
+bool BASE_PipeCollect(BASE_Pipe *pipe, BASE_Chunk *chunk) {
+    (void)pipe;
+    (void)chunk;
+    return false;
+}
+#endif
+
+// --- Completion queue ---
+
+#if TINY_CBASE_THREADS
+// Finished jobs, pushed by any pool thread and popped by the owner: a bounded
+// ring whose cells carry a sequence number (pos + 1 once filled, pos + size
+// once free again). Submissions stop at `size` unpolled jobs, so a push always
+// finds its cell free.
+typedef struct {
+    _Atomic size_t seq;
+    BASE_Job *job;
+} base_cq_cell;
+
+struct BASE_Queue {
+    base_cq_cell *cell;
+    size_t mask;
+    char pad0[48];
+    _Atomic size_t tail;       // next cell to fill, any pool thread
+    char pad1[56];
+    size_t head;               // next cell to pop, owner only
+    atomic_size_t unpolled;    // submitted and not yet polled
+    atomic_size_t running;     // submitted and not yet pushed; drops to 0 under `lock`
+    pthread_mutex_t lock;
+    pthread_cond_t idle;       // running reached 0, for BASE_QueueDestroy
+    atomic_bool signalled;     // the fd is (or is about to be) readable
+    int fd[2];                 // read and write ends; one eventfd on Linux
+};
+
+static void base_queue_signal(BASE_Queue *q) {
+#if TINY_CBASE_EVENTFD
+    uint64_t one = 1;
+#else
+    uint8_t one = 1;
+#endif
+    // One wake-up per batch of completions: the owner clears the flag when it finds the ring empty
+    if (!atomic_exchange(&q->signalled, true)) {
+        while (write(q->fd[1], &one, sizeof(one)) < 0 && errno == EINTR) {}
+    }
+}
+
+static void base_queue_drain(BASE_Queue *q) {
+    uint64_t buf[8];
+    for (;;) {
+        ssize_t n = read(q->fd[0], buf, sizeof(buf));
+        if (n != (ssize_t)sizeof(buf) && (n >= 0 || errno != EINTR)) break;
+    }
+}
+
+static void base_queue_done(BASE_Job *job, void *ctx) {
+    BASE_Queue *q = (BASE_Queue *)ctx;
+    size_t pos = atomic_fetch_add_explicit(&q->tail, 1, memory_order_relaxed);
+    base_cq_cell *c = &q->cell[pos & q->mask];
+
+    // Free already (the depth bound); the acquire orders this write after the owner's read
+    while (atomic_load_explicit(&c->seq, memory_order_acquire) != pos) {}
+    c->job = job;
+    atomic_store_explicit(&c->seq, pos + 1, memory_order_release);
+    base_queue_signal(q);
+
+    // Under the lock so BASE_QueueDestroy cannot free q between the decrement and the wake-up
+    pthread_mutex_lock(&q->lock);
+    if (atomic_fetch_sub(&q->running, 1) == 1) pthread_cond_signal(&q->idle);
+    pthread_mutex_unlock(&q->lock); // q may be destroyed from here on
+}
+
+BASE_Queue *BASE_QueueCreate(size_t depth) {
+    BASE_Queue *q = (BASE_Queue *)calloc(1, sizeof(*q));
+    if (!q) return NULL;
+    if (pthread_mutex_init(&q->lock, NULL) != 0) {
+        free(q);
+        return NULL;
+    }
+    if (pthread_cond_init(&q->idle, NULL) != 0) {
+        pthread_mutex_destroy(&q->lock);
+        free(q);
+        return NULL;
+    }
+
+    size_t size = 2;
+    while (size < depth) size <<= 1;
+    q->cell = (base_cq_cell *)malloc(size * sizeof(base_cq_cell));
+    q->mask = size - 1;
+    q->fd[0] = q->fd[1] = -1;
+    if (!q->cell) {
+        BASE_QueueDestroy(q);
+        return NULL;
+    }
+    for (size_t i = 0; i < size; i++) atomic_init(&q->cell[i].seq, i);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->unpolled, 0);
+    atomic_init(&q->running, 0);
+    atomic_init(&q->signalled, false);
+
+#if TINY_CBASE_EVENTFD
+    q->fd[0] = q->fd[1] = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (q->fd[0] < 0) {
+#else
+    if (pipe(q->fd) < 0 || fcntl(q->fd[0], F_SETFL, O_NONBLOCK) < 0 || fcntl(q->fd[1], F_SETFL, O_NONBLOCK) < 0 ||
+        fcntl(q->fd[0], F_SETFD, FD_CLOEXEC) < 0 || fcntl(q->fd[1], F_SETFD, FD_CLOEXEC) < 0) {
+#endif
+        BASE_QueueDestroy(q);
+        return NULL;
+    }
+    return q;
+}
+
+void BASE_QueueDestroy(BASE_Queue *queue) {
+    if (!queue) return;
+    pthread_mutex_lock(&queue->lock);
+    while (atomic_load(&queue->running)) pthread_cond_wait(&queue->idle, &queue->lock);
+    pthread_mutex_unlock(&queue->lock);
+    pthread_cond_destroy(&queue->idle);
+    pthread_mutex_destroy(&queue->lock);
+    if (queue->fd[0] >= 0) close(queue->fd[0]);
+    if (queue->fd[1] >= 0 && queue->fd[1] != queue->fd[0]) close(queue->fd[1]);
+    free(queue->cell);
+    free(queue);
+}
+
+int BASE_QueueFd(const BASE_Queue *queue) {
+    return queue ? queue->fd[0] : -1;
+}
+
+static bool base_queue_submit(BASE_Queue *q, BASE_Job *job, bool decode) {
+    if (!q || !job) return false;
+
+    // Reserve a completion cell
+    size_t n = atomic_load(&q->unpolled);
+    do {
+        if (n > q->mask) return false;
+    } while (!atomic_compare_exchange_weak(&q->unpolled, &n, n + 1));
+
+    atomic_fetch_add(&q->running, 1);
+    base_job_offload(job, decode, base_queue_done, q);
+    return true;
+}
+
+bool BASE_QueueEncode(BASE_Queue *queue, BASE_Job *job) {
+    return base_queue_submit(queue, job, false);
+}
+
+bool BASE_QueueDecode(BASE_Queue *queue, BASE_Job *job) {
+    return base_queue_submit(queue, job, true);
+}
+
+static BASE_Job *base_queue_pop(BASE_Queue *q) {
+    base_cq_cell *c = &q->cell[q->head & q->mask];
+    if (atomic_load_explicit(&c->seq, memory_order_acquire) != q->head + 1) return NULL;
+
+    BASE_Job *job = c->job;
+    atomic_store_explicit(&c->seq, q->head + q->mask + 1, memory_order_release);
+    q->head++;
+    atomic_fetch_sub(&q->unpolled, 1);
+    return job;
+}
+
+BASE_Job *BASE_QueuePoll(BASE_Queue *queue) {
+    if (!queue) return NULL;
+
+    BASE_Job *job = base_queue_pop(queue);
+    if (job) return job;
+
+    // Empty: rearm the wake-up, then look again for a push that raced with it
+    base_queue_drain(queue);
+    atomic_store(&queue->signalled, false);
+    atomic_thread_fence(memory_order_seq_cst);
+    return base_queue_pop(queue);
+}
+#else
+BASE_Queue *BASE_QueueCreate(size_t depth) {
+    (void)depth;
+    return NULL;
+}
+
+void BASE_QueueDestroy(BASE_Queue *queue) {
+    (void)queue;
+}
+
+int BASE_QueueFd(const BASE_Queue *queue) {
+    (void)queue;
+    return -1;
+}
+
+bool BASE_QueueEncode(BASE_Queue *queue, BASE_Job *job) {
+    (void)queue;
+    (void)job;
+    return false;
+}
+
+bool BASE_QueueDecode(BASE_Queue *queue, BASE_Job *job) {
+    (void)queue;
+    (void)job;
+    return false;
+}
+
+BASE_Job *BASE_QueuePoll(BASE_Queue *queue) {
+    (void)queue;
+    return NULL;
+}
+#endif
+
+// --- File descriptors ---
+
+#if TINY_CBASE_FDIO
+// Waits out EAGAIN on a non-blocking descriptor
+static bool base_fd_wait(int fd, short events) {
+    struct pollfd pfd = { fd, events, 0 };
+    while (poll(&pfd, 1, -1) < 0) {
+        if (errno != EINTR) return false;
+    }
+    return true;
+}
+
+// Up to len bytes, fewer only at end of input or when a non-blocking fd runs dry; -1 on error
+static ssize_t base_fd_read(int fd, uint8_t *buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = read(fd, buf + got, len - got);
+        if (n > 0) {
+            got += (size_t)n;
+        } else if (n == 0) {
+            break;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            if (got) break;
+            if (!base_fd_wait(fd, POLLIN)) return -1;
+        } else if (errno != EINTR) {
+            return -1;
+        }
+    }
+    return (ssize_t)got;
+}
+
+static bool base_fd_write(int fd, const uint8_t *buf, size_t len) {
+    while (len) {
+        ssize_t n = write(fd, buf, len);
+        if (n > 0) {
+            buf += n;
+            len -= (size_t)n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!base_fd_wait(fd, POLLOUT)) return false;
+        } else if (n == 0 || errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if defined(__linux__)
+// Largest pipe F_SETPIPE_SZ grants without CAP_SYS_RESOURCE; 0 if unknown
+static size_t base_fd_pipe_max(void) {
+    unsigned long max = 0;
+    FILE *f = fopen("/proc/sys/fs/pipe-max-size", "r");
+    if (!f) return 0;
+    if (fscanf(f, "%lu", &max) != 1) max = 0;
+    fclose(f);
+    return (size_t)max;
+}
+
+// Hands the pages to the pipe; buf must not be written again (it is unmapped after)
+static bool base_fd_gift(int fd, uint8_t *buf, size_t len) {
+    struct iovec iov = { buf, len };
+    while (iov.iov_len) {
+        ssize_t n = vmsplice(fd, &iov, 1, SPLICE_F_GIFT);
+        if (n > 0) {
+            iov.iov_base = (uint8_t *)iov.iov_base + n;
+            iov.iov_len -= (size_t)n;
+        } else if (n < 0 && errno == EAGAIN) {
+            if (!base_fd_wait(fd, POLLOUT)) return false;
+        } else if (n == 0 || errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif
+
+static bool base_fd_run(int in_fd, int out_fd, int mode_flags, bool decode, size_t *out_len, BASE_Error *err) {
+    base_coder coder;
+    size_t total = 0;
+    bool gift = false, ok = false, eof = false;
+
+    if (err) {
+        err->reason = BASE_ERR_NONE;
+        err->offset = 0;
+        err->ch = 0;
+    }
+    if (out_len) *out_len = 0;
+    if (in_fd < 0 || out_fd < 0 || !base_coder_init(&coder, mode_flags, decode)) {
+        if (err) err->reason = BASE_ERR_ARGS;
+        return false;
+    }
+
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t chunk = BASE_FD_CHUNK;
+    size_t out_cap = (base_coder_out_len(&coder, chunk) + page - 1) & ~(page - 1);
+
+#if defined(__linux__)
+    // A pipe gets the output pages themselves; make room for two chunks so a round is one vmsplice
+    struct stat st;
+    if (fstat(out_fd, &st) == 0 && S_ISFIFO(st.st_mode)) {
+        gift = true;
+        size_t want = 2 * out_cap, max = base_fd_pipe_max();
+        if (max && want > max) want = max;
+        int size = fcntl(out_fd, F_GETPIPE_SZ);
+        if (size >= 0 && (size_t)size < want && fcntl(out_fd, F_SETPIPE_SZ, (int)want) >= 0) size = fcntl(out_fd, F_GETPIPE_SZ);
+
+        // Capped (pipe-max-size, or the pipe could not grow): code smaller chunks that fit twice
+        if (size > 0 && (size_t)size < 2 * out_cap) {
+            size_t fit = (size_t)size / 2 / page * page;
+            if (fit < page) fit = page;
+            chunk = ((fit - 1) / coder.out_q - 1) * coder.in_q;
+            out_cap = (base_coder_out_len(&coder, chunk) + page - 1) & ~(page - 1);
+        }
+    }
+#endif
+
+    uint8_t *in = (uint8_t *)BASE_AllocBuffer(chunk);
+    uint8_t *out = gift ? NULL : (uint8_t *)BASE_AllocBuffer(out_cap);
+    if (!in || (!gift && !out)) goto done;
+
+    while (!eof) {
+        ssize_t got = base_fd_read(in_fd, in, chunk);
+        if (got < 0) goto done;
+        eof = got == 0;
+
+        uint8_t *buf = out;
+#if defined(__linux__)
+        // Gifted pages belong to the pipe until read: each round codes into fresh ones
+        if (gift) {
+            buf = (uint8_t *)mmap(NULL, out_cap, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+            if (buf == MAP_FAILED) goto done;
+        }
+#endif
+
+        size_t n = 0;
+        bool sent = base_coder_run(&coder, in, (size_t)got, eof, buf, &n);
+#if defined(__linux__)
+        if (gift) {
+            sent = sent && base_fd_gift(out_fd, buf, n);
+            munmap(buf, out_cap);
+        } else
+#endif
+        sent = sent && base_fd_write(out_fd, buf, n);
+
+        if (!sent) {
+            if (coder.failed && err) *err = coder.err;
+            goto done;
+        }
+        total += n;
+    }
+    ok = true;
+
+done:
+    BASE_FreeBuffer(in, chunk);
+    BASE_FreeBuffer(out, out_cap);
+    if (out_len) *out_len = total;
+    return ok;
+}
+
+bool BASE_EncodeFd(int in_fd, int out_fd, int mode_flags, size_t *out_len) {
+    return base_fd_run(in_fd, out_fd, mode_flags, false, out_len, NULL);
+}
+
+bool BASE_DecodeFd(int in_fd, int out_fd, int mode_flags, size_t *out_len, BASE_Error *err) {
+    return base_fd_run(in_fd, out_fd, mode_flags, true, out_len, err);
+}
+#else
+bool BASE_EncodeFd(int in_fd, int out_fd, int mode_flags, size_t *out_len) {
+    (void)in_fd;
+    (void)out_fd;
+    (void)mode_flags;
+    if (out_len) *out_len = 0;
+    return false;
+}
+
+bool BASE_DecodeFd(int in_fd, int out_fd, int mode_flags, size_t *out_len, BASE_Error *err) {
+    (void)in_fd;
+    (void)out_fd;
+    (void)mode_flags;
+    if (out_len) *out_len = 0;
+    if (err) {
+        err->reason = BASE_ERR_ARGS;
+        err->offset = 0;
+        err->ch = 0;
+    }
+    return false;
+}
+#endif
 
 #endif // TINY_CBASE_IMPLEMENTATION
\ No newline at end of file
@@ -44,6 +44,17 @@ extern "C" {
 #define TINY_CBASE_ENABLE_BASE85 1
 #endif
 
+// SIMD kernels (SSE2/AVX2 on x86), selected at compile time; 0 = scalar loops only
+#ifndef TINY_CBASE_ENABLE_SIMD
+#define TINY_CBASE_ENABLE_SIMD 1
+#endif
+
+// Worker thread pool for the parallel and batch calls (pthreads; NUMA
+// placement on Linux); 0 = those calls run on the calling thread
+#ifndef TINY_CBASE_ENABLE_THREADS
+#define TINY_CBASE_ENABLE_THREADS 1
+#endif
+
 #ifndef BASE_TRUNCATE_ON_NULL
 #define BASE_TRUNCATE_ON_NULL 0
 #endif
@@ -57,6 +68,30 @@ extern "C" {
 //
 // --- Function prototypes and Length macros ---
 //
+
+// Constant-time mode for key material (Base16 and Base64): arithmetic-only
+// char mapping, no secret-dependent branches or table loads. Combine with the
+// codec's own flags, e.g. BASE64_STD_ENC | BASE_CONST_TIME.
+#define BASE_CONST_TIME 0x8000000
+
+// Why a decode failed, reported by BASE_DecodeEx. Filled on the failure path
+// only; the plain BASE*_Decode functions keep returning a bare bool.
+typedef enum {
+    BASE_ERR_NONE = 0,
+    BASE_ERR_ARGS,          // NULL pointer, empty input or unknown mode
+    BASE_ERR_INVALID_CHAR,  // char outside the alphabet
+    BASE_ERR_BAD_PADDING,   // misplaced, inconsistent or non-zero padding
+    BASE_ERR_BAD_LENGTH,    // input length not valid for the mode
+    BASE_ERR_BAD_FRAME,     // missing or malformed "<~ ~>" / btoa framing
+    BASE_ERR_CHECKSUM       // btoa trailer does not match the data
+} BASE_ErrorCode;
+
+typedef struct {
+    BASE_ErrorCode reason;
+    size_t offset;          // offset into the encoded input
+    char ch;                // offending char for INVALID_CHAR / BAD_PADDING, else 0
+} BASE_Error;
+
 #if TINY_CBASE_ENABLE_BASE16
 #define BASE16_UPPER  0x01
 #define BASE16_LOWER  0x02
@@ -72,12 +107,28 @@ extern "C" {
 bool BASE16_Encode(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len, int mode_flags);
 bool BASE16_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len);
 
+// Constant-time decode (BASE16_Decode has no mode flags)
+bool BASE16_DecodeConstTime(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len);
+
+// Decodes only bytes [byte_off, byte_off + byte_len) of the unwrapped
+// encoding, reading just the quanta that cover them; out_decoded gets exactly
+// byte_len bytes. False when the range runs past the data or those quanta do
+// not decode (the rest of the input is not looked at).
+bool BASE16_DecodeRange(const char *encoded_data, size_t encoded_len, size_t byte_off, size_t byte_len, uint8_t *out_decoded);
+
 static FORCE_INLINE bool BASE16_EncodeUpper(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
     return BASE16_Encode(data, data_len, out_encoded, out_encoded_len, BASE16_UPPER);
 }
 static FORCE_INLINE bool BASE16_EncodeLower(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
     return BASE16_Encode(data, data_len, out_encoded, out_encoded_len, BASE16_LOWER);
 }
+
+static FORCE_INLINE bool BASE16_EncodeUpperCT(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
+    return BASE16_Encode(data, data_len, out_encoded, out_encoded_len, BASE16_UPPER | BASE_CONST_TIME);
+}
+static FORCE_INLINE bool BASE16_EncodeLowerCT(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
+    return BASE16_Encode(data, data_len, out_encoded, out_encoded_len, BASE16_LOWER | BASE_CONST_TIME);
+}
 #endif
 
 #if TINY_CBASE_ENABLE_BASE32
@@ -96,6 +147,9 @@ static FORCE_INLINE bool BASE16_EncodeLower(const uint8_t *data, size_t data_len
 bool BASE32_Encode(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len, int mode_flags);
 bool BASE32_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags);
 
+// Bytes [byte_off, byte_off + byte_len) only, as BASE16_DecodeRange
+bool BASE32_DecodeRange(const char *encoded_data, size_t encoded_len, size_t byte_off, size_t byte_len, uint8_t *out_decoded, int mode_flags);
+
 static FORCE_INLINE bool BASE32_EncodeStd(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
     return BASE32_Encode(data, data_len, out_encoded, out_encoded_len, BASE32_ENC);
 }
@@ -142,6 +196,10 @@ bool BASE58_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
 #define BASE64_NOPAD_ENC      0x4000
 #define BASE64_NOPAD_DEC      0x8000
 
+// WHATWG forgiving-base64 decode (browser atob()): ASCII whitespace is ignored,
+// padding is optional. Combine with BASE64_STD_DEC (or BASE64_URL_DEC).
+#define BASE64_FORGIVING_DEC  0x4000000
+
 // Base64 (RFC 4648) length macros
 #define BASE64_ENC_LEN(data_len) (4 * (((size_t)(data_len) + 2) / 3) + 2) // +2 for '\0' and safety
 #define BASE64_DEC_LEN(data_len) (((size_t)(data_len) + 3) / 4 * 3 + 1) // +1 for safety
@@ -149,6 +207,80 @@ bool BASE58_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_de
 bool BASE64_Encode(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len, int mode_flags);
 bool BASE64_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags);
 
+// Bytes [byte_off, byte_off + byte_len) only, as BASE16_DecodeRange (not with BASE64_FORGIVING_DEC)
+bool BASE64_DecodeRange(const char *encoded_data, size_t encoded_len, size_t byte_off, size_t byte_len, uint8_t *out_decoded, int mode_flags);
+
+// JSON string tokens: encode writes the quoted string (no escaping is ever
+// needed), decode takes the token as it appears in the JSON text, quotes
+// included, and resolves escapes such as "\/" and "\u002F" while decoding.
+#define BASE64_JSON_ENC_LEN(data_len) (BASE64_ENC_LEN(data_len) + 2) // +2 for the quotes
+
+bool BASE64_EncodeJson(const uint8_t *data, size_t data_len, char *out_json, size_t *out_json_len, int mode_flags);
+bool BASE64_DecodeJson(const char *json, size_t json_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags);
+
+// Data URIs ("data:<mime>;base64,<body>"). The length macro is exact: header,
+// padded body and '\0'. Parsing returns views into the URI, no copies.
+#define BASE64_DATA_URI_LEN(mime_len, data_len) (sizeof("data:;base64,") - 1 + (size_t)(mime_len) + 4 * (((size_t)(data_len) + 2) / 3) + 1)
+
+typedef struct {
+    const char *mime;       // mediatype, e.g. "image/png" (may be empty)
+    size_t mime_len;
+    const char *params;     // remaining ";key=value" parameters, without ";base64"
+    size_t params_len;
+    const char *body;       // data after the ','
+    size_t body_len;
+    bool is_base64;
+} BASE64_DataUri;
+
+bool BASE64_EncodeDataUri(const char *mime, const uint8_t *data, size_t data_len, char *out_uri, size_t *out_uri_len);
+bool BASE64_ParseDataUri(const char *uri, size_t uri_len, BASE64_DataUri *out_view);
+// Parses the URI and decodes its body into arena, which must hold at least
+// BASE64_DEC_LEN(body_len) - 1 bytes; out_view is filled as by BASE64_ParseDataUri.
+// Percent escapes in the body ("SGk%3D") are resolved while decoding; the view
+// still points at the raw, escaped body.
+bool BASE64_DecodeDataUri(const char *uri, size_t uri_len, uint8_t *arena, size_t arena_len, BASE64_DataUri *out_view, size_t *out_decoded_len);
+
+// JWT ("header.payload.signature", base64url without padding). All three
+// segments are decoded back to back into one arena; offsets are into arena.
+// Tokens with any '=' are rejected, as RFC 7515 base64url has no padding.
+#define BASE64_JWT_DEC_LEN(token_len) ((size_t)(token_len) / 4 * 3 + 2)
+
+typedef struct {
+    size_t header_off, header_len;
+    size_t payload_off, payload_len;
+    size_t signature_off, signature_len;
+} BASE64_Jwt;
+
+bool BASE64_DecodeJwt(const char *token, size_t token_len, uint8_t *arena, size_t arena_len, BASE64_Jwt *out_parts, size_t *out_decoded_len);
+
+// Line-wrapped bodies (MIME, PEM): an index built in one pass lets
+// BASE64_DecodeRangeIndexed jump near any decoded offset. It keeps one
+// checkpoint per BASE64_INDEX_STEP decoded bytes, each at the start of a line
+// where a quantum starts; marks (caller-provided) needs
+// BASE64_INDEX_MARKS(text_len) entries. Lines end in "\n" or "\r\n"; the text
+// is the body only (no PEM armor lines). Not with BASE64_FORGIVING_DEC.
+#ifndef BASE64_INDEX_STEP
+#define BASE64_INDEX_STEP ((size_t)64 << 10) // decoded bytes between checkpoints
+#endif
+#define BASE64_INDEX_MARKS(text_len) ((size_t)(text_len) / 4 * 3 / BASE64_INDEX_STEP + 2)
+
+typedef struct {
+    size_t enc_off;     // text offset of a line start where a quantum starts
+    size_t dec_off;     // decoded offset of that quantum
+} BASE64_LineMark;
+
+typedef struct {
+    BASE64_LineMark *marks;
+    size_t count;
+    size_t dec_len;     // decoded length of the whole body
+    int mode_flags;     // decode flags the index was built for
+} BASE64_LineIndex;
+
+bool BASE64_IndexLines(const char *text, size_t text_len, int mode_flags, BASE64_LineMark *marks, size_t max_marks, BASE64_LineIndex *out_index);
+
+// Bytes [byte_off, byte_off + byte_len) of an indexed body, as BASE64_DecodeRange
+bool BASE64_DecodeRangeIndexed(const char *text, size_t text_len, const BASE64_LineIndex *index, size_t byte_off, size_t byte_len, uint8_t *out_decoded);
+
 static FORCE_INLINE bool BASE64_EncodeStd(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
     return BASE64_Encode(data, data_len, out_encoded, out_encoded_len, BASE64_STD_ENC);
 }
@@ -160,7 +292,7 @@ static FORCE_INLINE bool BASE64_EncodeStdNoPad(const uint8_t *data, size_t data_
     return BASE64_Encode(data, data_len, out_encoded, out_encoded_len, BASE64_STD_ENC | BASE64_NOPAD_ENC);
 }
 static FORCE_INLINE bool BASE64_DecodeStdNoPad(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
-    return BASE64_Decode(encoded_data, encoded_len, out_decoded, out_decoded_len, BASE64_STD_DEC | BASE64_NOPAD_ENC);
+    return BASE64_Decode(encoded_data, encoded_len, out_decoded, out_decoded_len, BASE64_STD_DEC | BASE64_NOPAD_DEC);
 }
 
 static FORCE_INLINE bool BASE64_EncodeUrl(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
@@ -174,7 +306,18 @@ static FORCE_INLINE bool BASE64_EncodeUrlNoPad(const uint8_t *data, size_t data_
     return BASE64_Encode(data, data_len, out_encoded, out_encoded_len, BASE64_URL_ENC | BASE64_NOPAD_ENC);
 }
 static FORCE_INLINE bool BASE64_DecodeUrlNoPad(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
-    return BASE64_Decode(encoded_data, encoded_len, out_decoded, out_decoded_len, BASE64_URL_DEC | BASE64_NOPAD_ENC);
+    return BASE64_Decode(encoded_data, encoded_len, out_decoded, out_decoded_len, BASE64_URL_DEC | BASE64_NOPAD_DEC);
+}
+
+static FORCE_INLINE bool BASE64_EncodeStdCT(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
+    return BASE64_Encode(data, data_len, out_encoded, out_encoded_len, BASE64_STD_ENC | BASE_CONST_TIME);
+}
+static FORCE_INLINE bool BASE64_DecodeStdCT(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
+    return BASE64_Decode(encoded_data, encoded_len, out_decoded, out_decoded_len, BASE64_STD_DEC | BASE_CONST_TIME);
+}
+
+static FORCE_INLINE bool BASE64_DecodeForgiving(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
+    return BASE64_Decode(encoded_data, encoded_len, out_decoded, out_decoded_len, BASE64_STD_DEC | BASE64_FORGIVING_DEC);
 }
 
 #endif
@@ -188,17 +331,69 @@ static FORCE_INLINE bool BASE64_DecodeUrlNoPad(const char *encoded_data, size_t
 #define BASE85_Z85_DEC   0x200000
 #define BASE85_IGNORE_WS 0x400000
 
+// Adobe framing: encode wraps the output in "<~" ... "~>" and breaks lines,
+// decode skips an optional leading "<~", ignores whitespace and stops at "~>".
+// Applies to both encode and decode, combine with BASE85_STD_* or BASE85_EXT_*.
+#define BASE85_ADOBE_FRAME 0x800000
+
+// btoa format: "xbtoa Begin" header, 78-column body and the
+// "xbtoa End N .. E .. S .. R .." trailer (length + checksums).
+// Applies to both encode and decode, combine with BASE85_STD_* or BASE85_EXT_*.
+#define BASE85_BTOA      0x1000000
+
+// Padded Z85: encode accepts any input length and writes a final partial group
+// of n bytes as n + 1 chars, like Ascii85 (and Python's base64.z85encode);
+// aligned input is plain Z85. The decoder takes the byte count from the length.
+// Applies to both encode and decode, combine with BASE85_Z85_*.
+#define BASE85_Z85_PAD   0x2000000
+
+// Line widths used by the framed formats
+#define ASCII85_FRAME_LINE_LEN 75
+#define BTOA_LINE_LEN          78
+#define BTOA_TRAILER_MAX       96 // "xbtoa End N <dec> <hex> E <hex> S <hex> R <hex>\n"
+
 // ASCII85
 #define ASCII85_ENC_LEN(data_len) (((size_t)(data_len) + 3) / 4 * 5 + 2) // +2 for '\0' and safety
 #define ASCII85_DEC_LEN(data_len) ((size_t)(data_len) / 5 * 4 + 4 + 1) // +1 for safety
 
+// Framed ASCII85: body + "<~" "~>" + one '\n' per ASCII85_FRAME_LINE_LEN chars
+// + one more when "~>" does not fit on the last line
+#define ASCII85_FRAMED_ENC_LEN(data_len) (ASCII85_ENC_LEN(data_len) + ASCII85_ENC_LEN(data_len) / ASCII85_FRAME_LINE_LEN + 5)
+
+// btoa: "xbtoa Begin\n" + body + one '\n' per BTOA_LINE_LEN chars + trailer
+#define BTOA_ENC_LEN(data_len) (ASCII85_ENC_LEN(data_len) + ASCII85_ENC_LEN(data_len) / BTOA_LINE_LEN + 1 + 12 + BTOA_TRAILER_MAX)
+
 // Z85
 #define Z85_ENC_LEN(data_len) (((size_t)(data_len) / 4) * 5 + 2) // +2 for '\0' and safety
 #define Z85_DEC_LEN(data_len) ((size_t)(data_len) / 5 * 4 + 1) // +1 for safety
 
+// Padded Z85: whole groups + a 2..4 char partial group
+#define Z85_PAD_ENC_LEN(data_len) (((size_t)(data_len) + 3) / 4 * 5 + 2) // +2 for '\0' and safety
+#define Z85_PAD_DEC_LEN(data_len) ((size_t)(data_len) / 5 * 4 + 3 + 1) // +1 for safety
+
 bool BASE85_Encode(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len, int mode_flags);
 bool BASE85_Decode(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags);
 
+// Same as BASE85_Decode, but also reports how many input chars were consumed.
+// With BASE85_ADOBE_FRAME/BASE85_BTOA decoding stops after the closing "~>" or
+// the btoa trailer line, so the caller can continue parsing the surrounding stream.
+bool BASE85_DecodeFramed(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len,
+                         size_t *out_consumed, int mode_flags);
+
+// RFC 1924: one 128-bit value (IPv6 address, 128-bit ID) <-> exactly 20 chars.
+// Unlike the other Base85 modes the whole value is a single base-85 number.
+#define RFC1924_BYTES 16
+#define RFC1924_CHARS 20
+
+// Batch buffers: `count` values of 16 bytes <-> `count` * 20 chars, contiguous
+#define RFC1924_ENC_LEN(count) ((size_t)(count) * RFC1924_CHARS + 1) // +1 for '\0'
+#define RFC1924_DEC_LEN(count) ((size_t)(count) * RFC1924_BYTES)
+
+bool BASE85_EncodeRfc1924(const uint8_t *data, char *out_encoded);
+bool BASE85_DecodeRfc1924(const char *encoded_data, uint8_t *out_decoded);
+bool BASE85_EncodeRfc1924Batch(const uint8_t *data, size_t count, char *out_encoded);
+bool BASE85_DecodeRfc1924Batch(const char *encoded_data, size_t count, uint8_t *out_decoded);
+
 static FORCE_INLINE bool BASE85_EncodeStd(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
     return BASE85_Encode(data, data_len, out_encoded, out_encoded_len, BASE85_STD_ENC);
 }
@@ -220,6 +415,13 @@ static FORCE_INLINE bool BASE85_DecodeZ85(const char *encoded_data, size_t encod
     return BASE85_Decode(encoded_data, encoded_len, out_decoded, out_decoded_len, BASE85_Z85_DEC);
 }
 
+static FORCE_INLINE bool BASE85_EncodeZ85Pad(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
+    return BASE85_Encode(data, data_len, out_encoded, out_encoded_len, BASE85_Z85_ENC | BASE85_Z85_PAD);
+}
+static FORCE_INLINE bool BASE85_DecodeZ85Pad(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
+    return BASE85_Decode(encoded_data, encoded_len, out_decoded, out_decoded_len, BASE85_Z85_DEC | BASE85_Z85_PAD);
+}
+
 static FORCE_INLINE bool BASE85_CheckZ85Len(size_t len) {
     return (len % 4) == 0;
 }
@@ -228,6 +430,20 @@ static FORCE_INLINE bool BASE85_CheckZ85Len(size_t len) {
 static FORCE_INLINE bool BASE85_DecodeStdIgnoreWS(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len) {
     return BASE85_Decode(encoded_data, encoded_len, out_decoded, out_decoded_len, BASE85_STD_DEC | BASE85_IGNORE_WS);
 }
+
+static FORCE_INLINE bool BASE85_EncodeAdobe(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
+    return BASE85_Encode(data, data_len, out_encoded, out_encoded_len, BASE85_STD_ENC | BASE85_ADOBE_FRAME);
+}
+static FORCE_INLINE bool BASE85_DecodeAdobe(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, size_t *out_consumed) {
+    return BASE85_DecodeFramed(encoded_data, encoded_len, out_decoded, out_decoded_len, out_consumed, BASE85_STD_DEC | BASE85_ADOBE_FRAME);
+}
+
+static FORCE_INLINE bool BASE85_EncodeBtoa(const uint8_t *data, size_t data_len, char *out_encoded, size_t *out_encoded_len) {
+    return BASE85_Encode(data, data_len, out_encoded, out_encoded_len, BASE85_STD_ENC | BASE85_BTOA);
+}
+static FORCE_INLINE bool BASE85_DecodeBtoa(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, size_t *out_consumed) {
+    return BASE85_DecodeFramed(encoded_data, encoded_len, out_decoded, out_decoded_len, out_consumed, BASE85_STD_DEC | BASE85_BTOA);
+}
 #endif
 
 static FORCE_INLINE size_t BASE_GetEncodeLen(size_t data_len, uint32_t mode) {
@@ -260,7 +476,11 @@ static FORCE_INLINE size_t BASE_GetEncodeLen(size_t data_len, uint32_t mode) {
 #if TINY_CBASE_ENABLE_BASE85
     if (mode & (BASE85_STD_ENC | BASE85_EXT_ENC | BASE85_Z85_ENC)) {
         if (mode & (BASE85_Z85_ENC)) {
-            return Z85_ENC_LEN(data_len);
+            return (mode & BASE85_Z85_PAD) ? Z85_PAD_ENC_LEN(data_len) : Z85_ENC_LEN(data_len);
+        } else if (mode & BASE85_BTOA) {
+            return BTOA_ENC_LEN(data_len);
+        } else if (mode & BASE85_ADOBE_FRAME) {
+            return ASCII85_FRAMED_ENC_LEN(data_len);
         } else {
             return ASCII85_ENC_LEN(data_len);
         }
@@ -292,7 +512,7 @@ static FORCE_INLINE size_t BASE_GetDecodeLen(size_t data_len, uint32_t mode) {
 #endif
 
 #if TINY_CBASE_ENABLE_BASE64
-    if (mode & (BASE64_STD_DEC | BASE64_URL_DEC | BASE64_NOPAD_DEC)) {
+    if (mode & (BASE64_STD_DEC | BASE64_URL_DEC | BASE64_NOPAD_DEC | BASE64_FORGIVING_DEC)) {
         return BASE64_DEC_LEN(data_len);
     }
 #endif
@@ -300,7 +520,7 @@ static FORCE_INLINE size_t BASE_GetDecodeLen(size_t data_len, uint32_t mode) {
 #if TINY_CBASE_ENABLE_BASE85
     if (mode & (BASE85_STD_DEC | BASE85_EXT_DEC | BASE85_Z85_DEC)) {
         if (mode & (BASE85_Z85_DEC)) {
-            return Z85_DEC_LEN(data_len);
+            return (mode & BASE85_Z85_PAD) ? Z85_PAD_DEC_LEN(data_len) : Z85_DEC_LEN(data_len);
         } else {
             return ASCII85_DEC_LEN(data_len);
         }
@@ -310,6 +530,185 @@ static FORCE_INLINE size_t BASE_GetDecodeLen(size_t data_len, uint32_t mode) {
     return 0; // unknown mode
 }
 
+// Same as the codec's own decoder selected by mode_flags (as in
+// BASE_GetDecodeLen), but on failure fills *err (may be NULL) with the reason,
+// the offset of the first bad char and the char itself.
+bool BASE_DecodeEx(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags, BASE_Error *err);
+const char *BASE_ErrorString(BASE_ErrorCode reason);
+
+// Guesses the encoding of data in one pass over a character-class bitmap.
+// Writes up to max_modes decode mode flags (e.g. BASE16_DECODE, BASE64_URL_DEC |
+// BASE64_NOPAD_DEC, BASE85_Z85_DEC) to out_modes, most likely first, and
+// returns how many were written. 0 means no supported encoding fits.
+#define BASE_DETECT_MAX 7
+
+size_t BASE_Detect(const char *data, size_t data_len, int *out_modes, size_t max_modes);
+
+// Outputs of at least this many bytes are written with non-temporal (streaming)
+// stores, so one large encode/decode does not evict the rest of the cache.
+// Applies to the Base16/32/64 and Z85 bulk loops on SSE2 targets. The value is
+// process-wide and may be changed while other threads code (calls already
+// running may still use the old value); SIZE_MAX turns streaming off.
+#ifndef BASE_STREAM_THRESHOLD_DEFAULT
+#define BASE_STREAM_THRESHOLD_DEFAULT ((size_t)32 << 20) // 32 MiB, about one server LLC
+#endif
+
+void BASE_SetStreamThreshold(size_t bytes);
+size_t BASE_GetStreamThreshold(void);
+
+// Software prefetch distance of the vector bulk loops, in bytes ahead of the
+// input cursor (about DRAM latency x kernel throughput); 0 leaves it to the
+// hardware prefetchers.
+#ifndef BASE_PREFETCH_DISTANCE
+#define BASE_PREFETCH_DISTANCE 1024
+#endif
+
+// Buffers for multi-MB inputs/outputs. From BASE_HUGEPAGE_SIZE up, Linux gets
+// a 2 MiB aligned mapping marked MADV_HUGEPAGE, so transparent huge pages can
+// back it (fewer dTLB misses); smaller requests and other systems use malloc.
+// Free with the same size that was allocated.
+#define BASE_HUGEPAGE_SIZE ((size_t)2 << 20)
+
+void *BASE_AllocBuffer(size_t size);
+void BASE_FreeBuffer(void *buf, size_t size);
+
+// Multi-threaded Base16, Base32, Base64 and Z85 for large buffers, on the
+// library's thread pool (below). The input is cut into pieces of whole quanta,
+// `threads` of them or one per pool thread (threads = 0), and idle workers
+// split them further. On Linux the pool's workers are spread over the NUMA
+// nodes found in sysfs and pinned to their node's CPUs, and each piece is
+// queued on the node holding its input pages. Output and errors are the same
+// as the serial call (BASE_DecodeEx offsets included); inputs under
+// 2 * BASE_PAR_MIN_RANGE bytes, threads = 1, and decode modes that do not split
+// (constant-time and forgiving Base64, Z85 with whitespace, Base58,
+// Ascii85) run on the calling thread. Base58 and Ascii85 encodes are
+// not supported and return false.
+#ifndef BASE_PAR_MIN_RANGE
+#define BASE_PAR_MIN_RANGE ((size_t)256 << 10) // 256 KiB of input per piece at least
+#endif
+
+bool BASE_EncodeParallel(const uint8_t *raw_data, size_t raw_len, char *out_encoded, size_t *out_encoded_len, int mode_flags, size_t threads);
+bool BASE_DecodeParallel(const char *encoded_data, size_t encoded_len, uint8_t *out_decoded, size_t *out_decoded_len, int mode_flags, size_t threads, BASE_Error *err);
+
+// One job of a batch. out is sized by the caller (BASE_GetEncodeLen /
+// BASE_GetDecodeLen); a Base58 encode reads out_len as the buffer size, like
+// BASE58_Encode. ok, out_len and err (decode failures) are filled in.
+typedef struct {
+    const void *in;     // raw bytes (encode) or encoded text (decode)
+    size_t in_len;
+    void *out;
+    size_t out_len;
+    int mode_flags;     // any codec's flags, as for BASE_GetEncodeLen/BASE_DecodeEx
+    bool ok;
+    BASE_Error err;
+} BASE_Job;
+
+// Runs every job on the work-stealing pool, the calling thread helping, and
+// returns true if all of them succeeded. Mixed sizes and codecs are fine:
+// large Base16/32/64/Z85 jobs are split across threads, runs of small jobs
+// are grouped and stolen by idle workers.
+bool BASE_EncodeBatch(BASE_Job *jobs, size_t n);
+bool BASE_DecodeBatch(BASE_Job *jobs, size_t n);
+
+// Offloads one job to the pool and returns at once. done(job, ctx) runs on
+// the pool thread that finishes it; job (and its buffers) must stay valid
+// until then. Returns false when the job could not be queued (built without
+// threads, out of memory): it then ran on the calling thread and done was
+// called before returning.
+typedef void (*BASE_JobDone)(BASE_Job *job, void *ctx);
+
+bool BASE_EncodeAsync(BASE_Job *job, BASE_JobDone done, void *ctx);
+bool BASE_DecodeAsync(BASE_Job *job, BASE_JobDone done, void *ctx);
+
+// The pool starts on first use with one worker per CPU but one (the
+// submitting thread helps; one worker at least). Call BASE_PoolStart first to pick the count
+// (0 = that default); it returns false when built without threads.
+// BASE_PoolStop joins the workers; no batch may be running.
+bool BASE_PoolStart(size_t workers);
+void BASE_PoolStop(void);
+
+// Pipeline stage: a stream coded chunk by chunk as it arrives, between
+// threads. One thread submits chunks (say, as they come off a socket), one
+// runs BASE_PipeProcess, one collects the results; each hop is a lock-free
+// single-producer/single-consumer ring of chunk descriptors, so nothing is
+// locked and only the codec touches the bytes. The stage carries a partial
+// quantum from one chunk into the next, and the chunks' outputs concatenated
+// are the one-shot encode (without its '\0') or decode of the whole stream.
+// Base16/32/64 and Z85 only, in the modes BASE_EncodeParallel /
+// BASE_DecodeParallel split (constant-time and forgiving Base64, Z85 with
+// whitespace are not); BASE_PipeCreate returns NULL for the others and when
+// built without threads.
+typedef struct BASE_Pipe BASE_Pipe;
+
+typedef struct {
+    const void *in;     // this chunk of the stream (raw bytes or encoded text)
+    size_t in_len;
+    void *out;          // BASE_PipeOutLen(pipe, in_len) bytes at least
+    size_t out_len;     // set by the stage
+    bool last;          // end of the stream: flush the carried partial quantum
+    bool ok;            // set by the stage; false from the first bad chunk on
+    BASE_Error err;     // why, the offset counting from the start of the stream
+    void *user;         // passed through untouched
+} BASE_Chunk;
+
+// ring_size chunks in flight per ring (rounded up to a power of two)
+BASE_Pipe *BASE_PipeCreate(int mode_flags, bool decode, size_t ring_size);
+void BASE_PipeDestroy(BASE_Pipe *pipe);
+size_t BASE_PipeOutLen(const BASE_Pipe *pipe, size_t in_len);
+
+// Producer side: queues a chunk; false when the input ring is full
+bool BASE_PipeSubmit(BASE_Pipe *pipe, const BASE_Chunk *chunk);
+
+// Stage: codes up to max queued chunks in order and passes them on; returns
+// how many (0: nothing queued or the output ring is full). Never blocks: the
+// thread running it picks its own way to wait.
+size_t BASE_PipeProcess(BASE_Pipe *pipe, size_t max);
+
+// Consumer side: next coded chunk; false when none is ready. A stream ends
+// with its last chunk; the next one starts a new stream.
+bool BASE_PipeCollect(BASE_Pipe *pipe, BASE_Chunk *chunk);
+
+// Completion queue for reactor loops: jobs run on the pool (as with
+// BASE_EncodeAsync) and, once finished, wait in a lock-free ring until the
+// owner polls them. BASE_QueueFd is an eventfd (a pipe outside Linux) that
+// turns readable when completions are waiting; add it to the epoll/poll set
+// and, when it fires, call BASE_QueuePoll until it returns NULL (that also
+// rearms the fd). Submit from any thread, poll from one. To find your own
+// state from a job, embed the BASE_Job in it. Returns NULL without threads.
+typedef struct BASE_Queue BASE_Queue;
+
+// depth jobs submitted and not yet polled at most (rounded up to a power of two)
+BASE_Queue *BASE_QueueCreate(size_t depth);
+// Waits for the jobs still running; those not polled are dropped
+void BASE_QueueDestroy(BASE_Queue *queue);
+int BASE_QueueFd(const BASE_Queue *queue);
+
+// false when depth jobs are outstanding; job and its buffers must stay valid until polled
+bool BASE_QueueEncode(BASE_Queue *queue, BASE_Job *job);
+bool BASE_QueueDecode(BASE_Queue *queue, BASE_Job *job);
+
+// Next finished job (ok, out_len, err filled in), NULL when none is waiting
+BASE_Job *BASE_QueuePoll(BASE_Queue *queue);
+
+// fd to fd: reads in_fd to end of input BASE_FD_CHUNK bytes at a time and
+// writes the encoding (no '\0') or decoding to out_fd. On Linux, when out_fd
+// is a pipe, each chunk is coded into freshly mapped (kernel-zeroed) pages
+// that are gifted to it with vmsplice(SPLICE_F_GIFT) and unmapped, rather
+// than copied by write(). A smaller pipe is grown to hold two chunks' output,
+// up to /proc/sys/fs/pipe-max-size; past that, chunks shrink to fit the pipe.
+// Non-blocking descriptors are waited on with poll(). Codecs and modes as for
+// BASE_PipeCreate; POSIX systems only.
+// out_len (may be NULL) gets the bytes written, also on failure: output
+// before a bad quantum has been written already. Decode failures fill err
+// (offset counted from where in_fd started); after an I/O error err->reason
+// is BASE_ERR_NONE and errno tells why.
+#ifndef BASE_FD_CHUNK
+#define BASE_FD_CHUNK ((size_t)1 << 20) // input per read() round
+#endif
+
+bool BASE_EncodeFd(int in_fd, int out_fd, int mode_flags, size_t *out_len);
+bool BASE_DecodeFd(int in_fd, int out_fd, int mode_flags, size_t *out_len, BASE_Error *err);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,101 @@
+/*
+ * File: tiny_cbase.hpp
+ * Author: 0xNullll
+ * Description: C++20 coroutine front end for the Tiny CBase thread pool.
+ *              co_await cbase::async_encode(...) / cbase::async_decode(...)
+ *              runs the job on the library's work-stealing pool (large
+ *              Base16/32/64/Z85 inputs in parallel chunks) and resumes the
+ *              coroutine when it completes, so an event loop thread never
+ *              blocks on codec work. Build tiny_cbase.c as C alongside.
+ * License: MIT
+ */
+
+
+#ifndef TINY_CBASE_HPP
+#define TINY_CBASE_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "tiny_cbase.h"
+
+namespace cbase {
+
+// Outcome of an awaited job
+struct result {
+    bool ok;
+    std::size_t len; // bytes written to the output
+    BASE_Error err;  // decode failures, as BASE_DecodeEx reports them
+};
+
+// Where the coroutine resumes. By default it resumes on the pool thread that
+// finished the job; an event loop passes a function that posts the handle to
+// its own thread (e.g. a self-pipe or eventfd wake-up) and resumes it there.
+using resume_fn = void (*)(std::coroutine_handle<> h, void *ctx);
+
+namespace detail {
+
+class job_awaiter {
+public:
+    job_awaiter(const void *in, std::size_t in_len, void *out, std::size_t out_cap, int mode_flags, bool decode,
+                resume_fn resume, void *resume_ctx) noexcept
+        : job_{in, in_len, out, out_cap, mode_flags, false, {BASE_ERR_NONE, 0, 0}},
+          decode_(decode), resume_(resume), resume_ctx_(resume_ctx) {}
+
+    job_awaiter(const job_awaiter &) = delete;
+    job_awaiter &operator=(const job_awaiter &) = delete;
+
+    bool await_ready() const noexcept { return false; }
+
+    // The job may complete on another thread before this returns; whichever
+    // side flips claimed_ second resumes the coroutine (here: by not suspending).
+    bool await_suspend(std::coroutine_handle<> h) noexcept {
+        handle_ = h;
+        if (decode_) BASE_DecodeAsync(&job_, &job_awaiter::done, this);
+        else BASE_EncodeAsync(&job_, &job_awaiter::done, this);
+        return !claimed_.exchange(true, std::memory_order_acq_rel);
+    }
+
+    result await_resume() const noexcept { return {job_.ok, job_.out_len, job_.err}; }
+
+private:
+    static void done(BASE_Job *, void *ctx) {
+        job_awaiter *self = static_cast<job_awaiter *>(ctx);
+        if (!self->claimed_.exchange(true, std::memory_order_acq_rel)) return; // still in await_suspend
+
+        // The awaiter lives in the coroutine frame: nothing of it is touched after this
+        if (self->resume_) self->resume_(self->handle_, self->resume_ctx_);
+        else self->handle_.resume();
+    }
+
+    BASE_Job job_;
+    bool decode_;
+    resume_fn resume_;
+    void *resume_ctx_;
+    std::coroutine_handle<> handle_;
+    std::atomic<bool> claimed_{false};
+};
+
+} // namespace detail
+
+// Encodes in into out with mode_flags (any codec, as for BASE_GetEncodeLen).
+// out must hold BASE_GetEncodeLen(in.size(), mode_flags) bytes; its size is
+// the buffer size Base58 expects. Both spans must outlive the co_await.
+inline detail::job_awaiter async_encode(std::span<const std::uint8_t> in, std::span<char> out, int mode_flags,
+                                        resume_fn resume = nullptr, void *resume_ctx = nullptr) noexcept {
+    return {in.data(), in.size(), out.data(), out.size(), mode_flags, false, resume, resume_ctx};
+}
+
+// Decodes in into out with mode_flags (as for BASE_DecodeEx). out must hold
+// BASE_GetDecodeLen(in.size(), mode_flags) bytes.
+inline detail::job_awaiter async_decode(std::span<const char> in, std::span<std::uint8_t> out, int mode_flags,
+                                        resume_fn resume = nullptr, void *resume_ctx = nullptr) noexcept {
+    return {in.data(), in.size(), out.data(), out.size(), mode_flags, true, resume, resume_ctx};
+}
+
+} // namespace cbase
+
+#endif // TINY_CBASE_HPP
@@ -0,0 +1,189 @@
+/*
+ * File: cbase_coro_test.cpp
+ * Author: 0xNullll
+ * Description: Compiles tiny_cbase.hpp with -std=c++20 and co_awaits
+ *              cbase::async_encode/async_decode against the serial codecs.
+ *              Coroutines resume either on the pool thread or, through a
+ *              custom resume_fn, on a small event loop that must be the
+ *              thread they come back on. Hundreds of tiny jobs run at once so
+ *              the job often finishes before await_suspend returns: both
+ *              sides of the awaiter's claim/resume handshake get exercised.
+ *              Run it under ThreadSanitizer after touching the awaiter.
+ * License: MIT
+ */
+
+#include "../src/tiny_cbase.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <coroutine>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct codec {
+    const char *name;
+    int enc_flags;
+    int dec_flags;
+    std::size_t raw_q; // raw length must be a multiple of this (Z85)
+    char bad;          // char outside the alphabet
+};
+
+const codec CODECS[] = {
+    { "base16",           BASE16_UPPER,                      BASE16_DECODE,                     1, 'G' },
+    { "base32",           BASE32_ENC,                        BASE32_DEC,                        1, '1' },
+    { "base64",           BASE64_STD_ENC,                    BASE64_STD_DEC,                    1, '-' },
+    { "base64_url_nopad", BASE64_URL_ENC | BASE64_NOPAD_ENC, BASE64_URL_DEC | BASE64_NOPAD_DEC, 1, '+' },
+    { "z85",              BASE85_Z85_ENC,                    BASE85_Z85_DEC,                    4, '~' },
+};
+
+std::atomic<unsigned long> cases{0}, failures{0};
+
+void fail(const char *what) {
+    if (failures.fetch_add(1) < 20) std::fprintf(stderr, "FAIL: %s\n", what);
+}
+
+// Single-threaded event loop: resume_fn posts handles here, run() resumes
+// them on the thread that called it until every coroutine has finished
+struct loop {
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::coroutine_handle<>> ready;
+    std::size_t pending = 0;
+    std::thread::id owner = std::this_thread::get_id();
+
+    void started() {
+        std::lock_guard<std::mutex> lk(m);
+        pending++;
+    }
+
+    void finished() {
+        std::lock_guard<std::mutex> lk(m);
+        pending--;
+        cv.notify_all();
+    }
+
+    void post(std::coroutine_handle<> h) {
+        std::lock_guard<std::mutex> lk(m);
+        ready.push_back(h);
+        cv.notify_all();
+    }
+
+    void run() {
+        std::unique_lock<std::mutex> lk(m);
+        while (pending > 0 || !ready.empty()) {
+            cv.wait(lk, [this] { return pending == 0 || !ready.empty(); });
+            while (!ready.empty()) {
+                std::coroutine_handle<> h = ready.front();
+                ready.pop_front();
+                lk.unlock();
+                h.resume();
+                lk.lock();
+            }
+        }
+    }
+};
+
+void post_to_loop(std::coroutine_handle<> h, void *ctx) {
+    static_cast<loop *>(ctx)->post(h);
+}
+
+// Fire-and-forget coroutine: starts at once, frees its frame when it returns
+struct task {
+    struct promise_type {
+        task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::abort(); }
+    };
+};
+
+// Encode, decode back, then decode with a planted bad char; every outcome must
+// match the serial call
+task round_trip(loop &lp, const codec &c, const std::uint8_t *raw, std::size_t len, bool on_loop) {
+    cbase::resume_fn resume = on_loop ? post_to_loop : nullptr;
+    void *ctx = on_loop ? &lp : nullptr;
+    char what[160];
+
+    std::vector<char> enc(BASE_GetEncodeLen(len, (std::uint32_t)c.enc_flags)), want(enc.size());
+    std::size_t want_len = 0;
+    // threads = 1 runs the serial codec on this thread
+    bool want_ok = BASE_EncodeParallel(raw, len, want.data(), &want_len, c.enc_flags, 1);
+
+    cbase::result r = co_await cbase::async_encode({raw, len}, enc, c.enc_flags, resume, ctx);
+    cases++;
+    std::snprintf(what, sizeof(what), "%s encode len=%zu on_loop=%d", c.name, len, on_loop);
+    if (on_loop && std::this_thread::get_id() != lp.owner) fail("resumed off the loop thread");
+    if (r.ok != want_ok || !r.ok || r.len != want_len || std::memcmp(enc.data(), want.data(), r.len) != 0) {
+        fail(what);
+        lp.finished();
+        co_return;
+    }
+
+    std::size_t text_len = r.len;
+    std::vector<std::uint8_t> dec(BASE_GetDecodeLen(text_len, (std::uint32_t)c.dec_flags) + 8);
+    r = co_await cbase::async_decode({enc.data(), text_len}, dec, c.dec_flags, resume, ctx);
+    cases++;
+    std::snprintf(what, sizeof(what), "%s decode len=%zu on_loop=%d", c.name, len, on_loop);
+    if (on_loop && std::this_thread::get_id() != lp.owner) fail("resumed off the loop thread");
+    if (!r.ok || r.len != len || std::memcmp(dec.data(), raw, len) != 0) fail(what);
+
+    enc[text_len / 2] = c.bad;
+    std::size_t n = 0;
+    BASE_Error want_err = { BASE_ERR_NONE, 0, 0 };
+    bool bad_ok = BASE_DecodeEx(enc.data(), text_len, dec.data(), &n, c.dec_flags, &want_err);
+    r = co_await cbase::async_decode({enc.data(), text_len}, dec, c.dec_flags, resume, ctx);
+    cases++;
+    std::snprintf(what, sizeof(what), "%s bad char len=%zu on_loop=%d", c.name, len, on_loop);
+    if (on_loop && std::this_thread::get_id() != lp.owner) fail("resumed off the loop thread");
+    if (r.ok != bad_ok || r.err.reason != want_err.reason || r.err.offset != want_err.offset) fail(what);
+
+    lp.finished();
+}
+
+} // namespace
+
+int main() {
+    static const std::size_t lens[] = { 1, 2, 3, 4, 63, 64, 100, 4096, (std::size_t)1 << 20 };
+    const std::size_t big = (std::size_t)1 << 20;
+    std::vector<std::uint8_t> raw(big);
+    std::uint64_t rng = 0x9E3779B97F4A7C15ull;
+    for (std::size_t i = 0; i < big; i++) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        raw[i] = (std::uint8_t)rng;
+    }
+
+    loop lp;
+    for (int on_loop = 0; on_loop < 2; on_loop++) {
+        for (const codec &c : CODECS) {
+            for (std::size_t len : lens) {
+                len -= len % c.raw_q;
+                if (!len) continue;
+                lp.started();
+                round_trip(lp, c, raw.data(), len, on_loop != 0);
+            }
+        }
+        // Tiny jobs race their own await_suspend
+        for (int k = 0; k < 400; k++) {
+            const codec &c = CODECS[k % (sizeof(CODECS) / sizeof(CODECS[0]))];
+            std::size_t len = (std::size_t)(4 + k % 29);
+            len -= len % c.raw_q;
+            lp.started();
+            round_trip(lp, c, raw.data() + k, len, on_loop != 0);
+        }
+        lp.run();
+    }
+
+    BASE_PoolStop();
+    std::printf("%lu cases, %lu failures\n", cases.load(), failures.load());
+    return failures ? 1 : 0;
+}
@@ -14,7 +14,10 @@ void print_usage(const char *prog) {
     printf("  base32_std, base32_std_nopad\n");
     printf("  base58\n");
     printf("  base64_std, base64_std_nopad, base64_url, base64_url_nopad\n");
-    printf("  base85_std, base85_ext, base85_z85\n");
+    printf("  base64_json (quoted JSON string token)\n");
+    printf("  base85_std, base85_ext, base85_z85, base85_adobe, base85_btoa\n");
+    printf("  base85_z85_pad (any input length)\n");
+    printf("  base85_rfc1924 (16-byte input)\n");
 }
 
 int main(int argc, char *argv[]) {
@@ -36,8 +39,11 @@ int main(int argc, char *argv[]) {
         strcmp(base_flag, "base32_std") == 0 || strcmp(base_flag, "base32_std_nopad") == 0 ||
         strcmp(base_flag, "base58") == 0 || strcmp(base_flag, "base64_std") == 0 ||
         strcmp(base_flag, "base64_std_nopad") == 0 || strcmp(base_flag, "base64_url") == 0 ||
-        strcmp(base_flag, "base64_url_nopad") == 0 || strcmp(base_flag, "base85_std") == 0 ||
-        strcmp(base_flag, "base85_ext") == 0 || strcmp(base_flag, "base85_z85") == 0) {
+        strcmp(base_flag, "base64_url_nopad") == 0 || strcmp(base_flag, "base64_json") == 0 ||
+        strcmp(base_flag, "base85_std") == 0 ||
+        strcmp(base_flag, "base85_ext") == 0 || strcmp(base_flag, "base85_z85") == 0 ||
+        strcmp(base_flag, "base85_adobe") == 0 || strcmp(base_flag, "base85_btoa") == 0 ||
+        strcmp(base_flag, "base85_rfc1924") == 0 || strcmp(base_flag, "base85_z85_pad") == 0) {
         is_hex = false; // treat input as string for raw encoding
     }
 
@@ -58,9 +64,9 @@ int main(int argc, char *argv[]) {
 
     // Encode or decode
     if (strcmp(mode, "enc") == 0) {
-        // Z85 must be multiple of 4
+        // Z85 must be multiple of 4 (base85_z85_pad takes any length)
         if (strcmp(base_flag, "base85_z85") == 0 && (input_len % 4 != 0)) {
-            fprintf(stderr, "Error: Z85 input length must be multiple of 4\n");
+            fprintf(stderr, "Error: Z85 input length must be multiple of 4 (use base85_z85_pad)\n");
             return 1;
         }
 
@@ -88,6 +94,20 @@ int main(int argc, char *argv[]) {
             ok = BASE85_EncodeExt(input_buf, input_len, encoded, &enc_len);
         } else if (strcmp(base_flag, "base85_z85") == 0) {
             ok = BASE85_EncodeZ85(input_buf, input_len, encoded, &enc_len);
+        } else if (strcmp(base_flag, "base64_json") == 0) {
+            ok = BASE64_EncodeJson(input_buf, input_len, encoded, &enc_len, BASE64_STD_ENC);
+        } else if (strcmp(base_flag, "base85_z85_pad") == 0) {
+            ok = BASE85_EncodeZ85Pad(input_buf, input_len, encoded, &enc_len);
+        } else if (strcmp(base_flag, "base85_adobe") == 0) {
+            ok = BASE85_EncodeAdobe(input_buf, input_len, encoded, &enc_len);
+        } else if (strcmp(base_flag, "base85_btoa") == 0) {
+            ok = BASE85_EncodeBtoa(input_buf, input_len, encoded, &enc_len);
+        } else if (strcmp(base_flag, "base85_rfc1924") == 0) {
+            if (input_len != RFC1924_BYTES) {
+                fprintf(stderr, "Error: RFC 1924 input must be exactly %d bytes\n", RFC1924_BYTES);
+                return 1;
+            }
+            ok = BASE85_EncodeRfc1924(input_buf, encoded);
         } else {
             fprintf(stderr, "Unknown base flag: %s\n", base_flag);
             return 1;
@@ -120,6 +140,8 @@ int main(int argc, char *argv[]) {
             ok = BASE64_DecodeUrl(encoded, enc_len, decoded, &dec_len);
         } else if (strcmp(base_flag, "base64_url_nopad") == 0) {
             ok = BASE64_DecodeUrlNoPad(encoded, enc_len, decoded, &dec_len);
+        } else if (strcmp(base_flag, "base64_json") == 0) {
+            ok = BASE64_DecodeJson(encoded, enc_len, decoded, &dec_len, BASE64_STD_DEC);
         } else if (strcmp(base_flag, "base85_std") == 0) {
             ok = BASE85_DecodeStd(encoded, enc_len, decoded, &dec_len);
         } else if (strcmp(base_flag, "base85_ext") == 0) {
@@ -130,6 +152,21 @@ int main(int argc, char *argv[]) {
                 return 1;
             }
             ok = BASE85_DecodeZ85(encoded, enc_len, decoded, &dec_len);
+        } else if (strcmp(base_flag, "base85_z85_pad") == 0) {
+            ok = BASE85_DecodeZ85Pad(encoded, enc_len, decoded, &dec_len);
+        } else if (strcmp(base_flag, "base85_adobe") == 0) {
+            size_t consumed;
+            ok = BASE85_DecodeAdobe(encoded, enc_len, decoded, &dec_len, &consumed);
+        } else if (strcmp(base_flag, "base85_btoa") == 0) {
+            size_t consumed;
+            ok = BASE85_DecodeBtoa(encoded, enc_len, decoded, &dec_len, &consumed);
+        } else if (strcmp(base_flag, "base85_rfc1924") == 0) {
+            if (enc_len != RFC1924_CHARS) {
+                fprintf(stderr, "Error: RFC 1924 input must be exactly %d chars\n", RFC1924_CHARS);
+                return 1;
+            }
+            ok = BASE85_DecodeRfc1924(encoded, decoded);
+            dec_len = RFC1924_BYTES;
         } else {
             fprintf(stderr, "Unknown base flag: %s\n", base_flag);
             return 1;
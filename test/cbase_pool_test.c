@@ -0,0 +1,254 @@
+/*
+ * File: cbase_pool_test.c
+ * Author: 0xNullll
+ * Description: Checks BASE_EncodeParallel/BASE_DecodeParallel and
+ *              BASE_EncodeBatch/BASE_DecodeBatch against the serial codecs on
+ *              the work-stealing pool, with 1, 3 and 8 workers and the
+ *              default. Inputs are large enough to be cut into pieces; bad
+ *              chars land on and around piece boundaries and padding in the
+ *              middle of the input, where output, length and error (reason,
+ *              offset, char) must match the serial call exactly. Batches mix
+ *              split jobs with runs of small ones, so run it under
+ *              ThreadSanitizer after touching the pool.
+ * License: MIT
+ */
+
+#include "../src/tiny_cbase.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+    const char *name;
+    int enc_flags;
+    int dec_flags;
+    size_t raw_q; // raw length must be a multiple of this (Z85)
+    char bad;     // char outside the alphabet
+    bool padded;  // '=' padding
+} codec;
+
+static const codec CODECS[] = {
+    { "base16",           BASE16_UPPER,                      BASE16_DECODE,                     1, 'G', false },
+    { "base32",           BASE32_ENC,                        BASE32_DEC,                        1, '1', true  },
+    { "base64",           BASE64_STD_ENC,                    BASE64_STD_DEC,                    1, '-', true  },
+    { "base64_url_nopad", BASE64_URL_ENC | BASE64_NOPAD_ENC, BASE64_URL_DEC | BASE64_NOPAD_DEC, 1, '+', false },
+    { "z85",              BASE85_Z85_ENC,                    BASE85_Z85_DEC,                    4, '~', false },
+    { "z85_pad",          BASE85_Z85_ENC | BASE85_Z85_PAD,   BASE85_Z85_DEC | BASE85_Z85_PAD,   1, '~', false },
+};
+
+#define NCODECS (sizeof(CODECS) / sizeof(CODECS[0]))
+// CMake builds this test with a small BASE_PAR_MIN_RANGE so that inputs of a
+// few hundred KiB are cut into many pieces
+#define BIG (BASE_PAR_MIN_RANGE * 9 + 777) // several pieces, the last one short
+
+static unsigned long cases, failures;
+static uint64_t rng = 0x9E3779B97F4A7C15ull;
+
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return (uint32_t)rng;
+}
+
+static void fail(const char *what) {
+    failures++;
+    if (failures <= 20) fprintf(stderr, "FAIL: %s\n", what);
+}
+
+static bool encode_serial(int flags, const uint8_t *raw, size_t len, char *out, size_t *out_len) {
+    if (flags & (BASE16_UPPER | BASE16_LOWER)) return BASE16_Encode(raw, len, out, out_len, flags);
+    if (flags & BASE32_ENC) return BASE32_Encode(raw, len, out, out_len, flags);
+    if (flags & (BASE64_STD_ENC | BASE64_URL_ENC)) return BASE64_Encode(raw, len, out, out_len, flags);
+    if (flags & BASE58_ENC) return BASE58_Encode(raw, len, out, out_len);
+    return BASE85_Encode(raw, len, out, out_len, flags);
+}
+
+// Outcome of one call, compared field by field
+typedef struct {
+    bool ok;
+    size_t n;
+    BASE_Error err;
+} outcome;
+
+static void compare(const char *what, const outcome *want, const uint8_t *want_out, const outcome *got, const uint8_t *got_out) {
+    char line[256];
+    cases++;
+    bool same = want->ok == got->ok;
+    if (same && want->ok) same = want->n == got->n && memcmp(want_out, got_out, want->n) == 0;
+    if (same && !want->ok) {
+        same = want->err.reason == got->err.reason && want->err.offset == got->err.offset && want->err.ch == got->err.ch;
+    }
+    if (!same) {
+        snprintf(line, sizeof(line), "%s: serial ok=%d n=%zu reason=%d offset=%zu, pool ok=%d n=%zu reason=%d offset=%zu", what,
+                 want->ok, want->n, (int)want->err.reason, want->err.offset, got->ok, got->n, (int)got->err.reason, got->err.offset);
+        fail(line);
+    }
+}
+
+static void decode_both(const codec *c, const char *label, const char *enc, size_t enc_len, size_t threads, uint8_t *a, uint8_t *b) {
+    outcome want = { false, 0, { BASE_ERR_NONE, 0, 0 } }, got = want;
+    char what[128];
+
+    want.ok = BASE_DecodeEx(enc, enc_len, a, &want.n, c->dec_flags, &want.err);
+    got.ok = BASE_DecodeParallel(enc, enc_len, b, &got.n, c->dec_flags, threads, &got.err);
+    snprintf(what, sizeof(what), "%s parallel decode %s len=%zu threads=%zu", c->name, label, enc_len, threads);
+    compare(what, &want, a, &got, b);
+}
+
+static void parallel_cases(const codec *c, const uint8_t *raw, char *enc, char *bent, uint8_t *a, uint8_t *b) {
+    static const size_t threads[] = { 0, 3 };
+    size_t lens[] = { BIG / c->raw_q * c->raw_q, (BASE_PAR_MIN_RANGE * 5 / 2 + 4321) / c->raw_q * c->raw_q };
+    char what[128], label[64];
+
+    for (size_t li = 0; li < sizeof(lens) / sizeof(lens[0]); li++) {
+        size_t len = lens[li];
+        for (size_t ti = 0; ti < sizeof(threads) / sizeof(threads[0]); ti++) {
+            size_t th = threads[ti];
+            outcome want = { false, 0, { BASE_ERR_NONE, 0, 0 } }, got = want;
+
+            want.ok = encode_serial(c->enc_flags, raw, len, (char *)a, &want.n);
+            got.ok = BASE_EncodeParallel(raw, len, (char *)b, &got.n, c->enc_flags, th);
+            snprintf(what, sizeof(what), "%s parallel encode len=%zu threads=%zu", c->name, len, th);
+            compare(what, &want, a, &got, b);
+
+            size_t enc_len = 0;
+            if (!encode_serial(c->enc_flags, raw, len, enc, &enc_len)) {
+                fail("serial encode");
+                continue;
+            }
+            decode_both(c, "clean", enc, enc_len, th, a, b);
+
+            // Bad chars at the ends, around page-sized granules and around
+            // likely piece boundaries, plus a few anywhere
+            size_t spots[32], ns = 0;
+            size_t marks[] = { 0, 16384, 65536, enc_len / 3, enc_len / 2, enc_len - 1 };
+            for (size_t m = 0; m < sizeof(marks) / sizeof(marks[0]); m++) {
+                for (size_t d = 0; d < 3; d++) {
+                    size_t p = marks[m] + d;
+                    if (p >= 1 && p - 1 < enc_len) spots[ns++] = p - 1;
+                }
+            }
+            for (size_t r = 0; r < 2; r++) spots[ns++] = next_rand() % enc_len;
+
+            for (size_t s = 0; s < ns; s++) {
+                memcpy(bent, enc, enc_len);
+                bent[spots[s]] = c->bad;
+                snprintf(label, sizeof(label), "bad@%zu", spots[s]);
+                decode_both(c, label, bent, enc_len, th, a, b);
+            }
+
+            // Padding in the middle of the input: a piece sees a short quantum
+            if (c->padded) {
+                size_t q = c->dec_flags & BASE32_DEC ? 8 : 4;
+                size_t where[] = { 16384, enc_len / 2, enc_len / 3 };
+                for (size_t w = 0; w < sizeof(where) / sizeof(where[0]); w++) {
+                    size_t p = where[w] / q * q + q - 2;
+                    if (p + 1 >= enc_len) continue;
+                    memcpy(bent, enc, enc_len);
+                    bent[p] = '=';
+                    bent[p + 1] = '=';
+                    snprintf(label, sizeof(label), "pad@%zu", p);
+                    decode_both(c, label, bent, enc_len, th, a, b);
+                }
+            }
+        }
+    }
+}
+
+// Split jobs (large, splittable) between runs of small ones of every codec,
+// some of them invalid; each job must match its serial run
+static void batch_cases(const uint8_t *raw) {
+    enum { NJOBS = 160 };
+    static BASE_Job jobs[NJOBS], dec[NJOBS];
+    static const codec base58 = { "base58", BASE58_ENC, BASE58_DEC, 1, '0', false };
+    uint8_t *ref = (uint8_t *)malloc(BIG * 2 + 64);
+    char what[128];
+
+    for (size_t j = 0; j < NJOBS; j++) {
+        const codec *c = j % 7 == 6 ? &base58 : &CODECS[j % NCODECS];
+        size_t len = c == &base58 ? next_rand() % 200 : j % 37 == 5 ? BIG : next_rand() % 5000;
+        len = len / c->raw_q * c->raw_q;
+        jobs[j].in = raw + j;
+        jobs[j].in_len = len;
+        jobs[j].out_len = BASE_GetEncodeLen(len, (uint32_t)c->enc_flags) + 8;
+        jobs[j].out = malloc(jobs[j].out_len);
+        jobs[j].mode_flags = c->enc_flags;
+    }
+
+    BASE_EncodeBatch(jobs, NJOBS);
+    for (size_t j = 0; j < NJOBS; j++) {
+        outcome want = { false, 0, { BASE_ERR_NONE, 0, 0 } }, got = { jobs[j].ok, jobs[j].out_len, jobs[j].err };
+        want.n = BASE_GetEncodeLen(jobs[j].in_len, (uint32_t)jobs[j].mode_flags) + 8;
+        want.ok = encode_serial(jobs[j].mode_flags, (const uint8_t *)jobs[j].in, jobs[j].in_len, (char *)ref, &want.n);
+        snprintf(what, sizeof(what), "batch encode job %zu flags=%#x len=%zu", j, (unsigned)jobs[j].mode_flags, jobs[j].in_len);
+        compare(what, &want, ref, &got, (const uint8_t *)jobs[j].out);
+    }
+
+    // Decode the results back, every third one bent
+    for (size_t j = 0; j < NJOBS; j++) {
+        const codec *c = j % 7 == 6 ? &base58 : &CODECS[j % NCODECS];
+        char *text = (char *)jobs[j].out;
+        size_t n = jobs[j].out_len;
+        if (j % 3 == 1 && n > 2) {
+            size_t p = next_rand() % n;
+            if (c->padded && j % 2) {
+                size_t q = c->dec_flags & BASE32_DEC ? 8 : 4;
+                p = p / q * q;
+                if (p + q < n) text[p + q - 1] = '=';
+            } else {
+                text[p] = c->bad;
+            }
+        }
+        dec[j].in = text;
+        dec[j].in_len = n;
+        dec[j].out = malloc(BASE_GetDecodeLen(n, (uint32_t)c->dec_flags) + 8);
+        dec[j].out_len = 0;
+        dec[j].mode_flags = c->dec_flags;
+    }
+
+    BASE_DecodeBatch(dec, NJOBS);
+    for (size_t j = 0; j < NJOBS; j++) {
+        outcome want = { false, 0, { BASE_ERR_NONE, 0, 0 } }, got = { dec[j].ok, dec[j].out_len, dec[j].err };
+        want.ok = BASE_DecodeEx((const char *)dec[j].in, dec[j].in_len, ref, &want.n, dec[j].mode_flags, &want.err);
+        snprintf(what, sizeof(what), "batch decode job %zu flags=%#x len=%zu", j, (unsigned)dec[j].mode_flags, dec[j].in_len);
+        compare(what, &want, ref, &got, (const uint8_t *)dec[j].out);
+    }
+
+    for (size_t j = 0; j < NJOBS; j++) {
+        free(jobs[j].out);
+        free(dec[j].out);
+    }
+    free(ref);
+}
+
+int main(void) {
+    static const size_t workers[] = { 1, 3, 8, 0 };
+    size_t cap = BIG * 2 + 64;
+    uint8_t *raw = (uint8_t *)malloc(BIG + 256);
+    char *enc = (char *)malloc(cap), *bent = (char *)malloc(cap);
+    uint8_t *a = (uint8_t *)malloc(cap), *b = (uint8_t *)malloc(cap);
+    if (!raw || !enc || !bent || !a || !b) {
+        fprintf(stderr, "out of memory\n");
+        return 2;
+    }
+    for (size_t i = 0; i < BIG + 256; i++) raw[i] = (uint8_t)next_rand();
+
+    for (size_t w = 0; w < sizeof(workers) / sizeof(workers[0]); w++) {
+        // Without threads the calls run serially and must still match
+        BASE_PoolStart(workers[w]);
+        for (size_t i = 0; i < NCODECS; i++) parallel_cases(&CODECS[i], raw, enc, bent, a, b);
+        batch_cases(raw);
+        BASE_PoolStop();
+    }
+
+    free(raw);
+    free(enc);
+    free(bent);
+    free(a);
+    free(b);
+    printf("%lu cases, %lu failures\n", cases, failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,679 @@
+/*
+ * File: cbase_test.c
+ * Author: 0xNullll
+ * Description: Round-trip and error-path checks for the Base16/32/64 and Z85
+ *              kernels. Lengths cross every vector block size, and bad chars
+ *              and padding are planted inside the blocks. Also covered: the
+ *              forgiving Base64 decoder, JSON tokens and data: URIs (percent
+ *              escapes included), the Adobe and btoa Ascii85 framings, padded
+ *              Z85, RFC 1924, JWT splitting, range decode and the wrapped
+ *              Base64 line index, and BASE_Detect. Each case is also
+ *              written as one line of a record; CTest runs the scalar build
+ *              (TINY_CBASE_ENABLE_SIMD=0) with --write and the SIMD build
+ *              with --check, so SSE2/AVX2/NEON must match scalar exactly,
+ *              error reasons and offsets included. Cross builds run both
+ *              through CMAKE_CROSSCOMPILING_EMULATOR (qemu-user).
+ * License: MIT
+ */
+
+#include "../src/tiny_cbase.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MAX_RAW 4200
+#define MAX_ENC (MAX_RAW * 2 + 64)
+
+typedef struct {
+    const char *name;
+    int enc_flags;
+    int dec_flags;
+    size_t raw_q;   // raw length must be a multiple of this (Z85)
+    char bad;       // char outside the alphabet
+    bool padded;    // '=' padding
+    bool first_bad; // errors point at the first bad char (not constant-time, not forgiving after "=")
+} codec;
+
+// The x86 vector paths are the constant-time and forgiving ones; AArch64 has
+// NEON kernels for the strict codecs as well
+static const codec CODECS[] = {
+    { "base16_upper",     BASE16_UPPER,                        BASE16_DECODE,                        1, 'G', false, true  },
+    { "base16_lower",     BASE16_LOWER,                        BASE16_DECODE,                        1, 'g', false, true  },
+    { "base16_ct",        BASE16_UPPER | BASE_CONST_TIME,      BASE16_DECODE | BASE_CONST_TIME,      1, 'G', false, false },
+    { "base32",           BASE32_ENC,                          BASE32_DEC,                           1, '1', true,  true  },
+    { "base32_nopad",     BASE32_ENC | BASE32_ENC_NOPAD,       BASE32_DEC | BASE32_DEC_NOPAD,        1, '8', false, true  },
+    { "base64",           BASE64_STD_ENC,                      BASE64_STD_DEC,                       1, '-', true,  true  },
+    { "base64_url_nopad", BASE64_URL_ENC | BASE64_NOPAD_ENC,   BASE64_URL_DEC | BASE64_NOPAD_DEC,    1, '+', false, true  },
+    { "base64_ct",        BASE64_STD_ENC | BASE_CONST_TIME,    BASE64_STD_DEC | BASE_CONST_TIME,     1, '-', true,  false },
+    { "base64_forgiving", BASE64_STD_ENC,                      BASE64_STD_DEC | BASE64_FORGIVING_DEC, 1, '-', true,  false },
+    { "z85",              BASE85_Z85_ENC,                      BASE85_Z85_DEC,                       4, '~', false, true  },
+    { "z85_pad",          BASE85_Z85_ENC | BASE85_Z85_PAD,     BASE85_Z85_DEC | BASE85_Z85_PAD,      1, '~', false, true  },
+};
+
+static FILE *record;      // --write: lines go here
+static FILE *reference;   // --check: lines are compared with these
+static unsigned long cases, failures;
+
+static uint64_t rng = 0x9E3779B97F4A7C15ull;
+
+static uint32_t next_rand(void) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    return (uint32_t)rng;
+}
+
+static uint64_t fnv1a(const uint8_t *p, size_t n) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < n; i++) h = (h ^ p[i]) * 0x100000001b3ull;
+    return h;
+}
+
+static void fail(const char *what) {
+    failures++;
+    if (failures <= 20) fprintf(stderr, "FAIL: %s\n", what);
+}
+
+// One outcome, written to or checked against the scalar record
+static void note(const char *line) {
+    cases++;
+    if (record) fprintf(record, "%s\n", line);
+    if (reference) {
+        char ref[256];
+        if (!fgets(ref, sizeof(ref), reference)) {
+            fail("record ends early");
+            reference = NULL;
+            return;
+        }
+        ref[strcspn(ref, "\n")] = '\0';
+        if (strcmp(ref, line) != 0) {
+            char msg[600];
+            snprintf(msg, sizeof(msg), "scalar: %s\n      simd:   %s", ref, line);
+            fail(msg);
+        }
+    }
+}
+
+static bool encode(const codec *c, const uint8_t *raw, size_t len, char *out, size_t *out_len) {
+    if (c->enc_flags & (BASE16_UPPER | BASE16_LOWER)) return BASE16_Encode(raw, len, out, out_len, c->enc_flags);
+    if (c->enc_flags & BASE32_ENC) return BASE32_Encode(raw, len, out, out_len, c->enc_flags);
+    if (c->enc_flags & (BASE64_STD_ENC | BASE64_URL_ENC)) return BASE64_Encode(raw, len, out, out_len, c->enc_flags);
+    return BASE85_Encode(raw, len, out, out_len, c->enc_flags);
+}
+
+static void decode_case(const codec *c, const char *label, const char *enc, size_t enc_len) {
+    static uint8_t out[MAX_ENC];
+    char line[256];
+    size_t n = 0;
+    BASE_Error err = { BASE_ERR_NONE, 0, 0 };
+
+    bool ok = BASE_DecodeEx(enc, enc_len, out, &n, c->dec_flags, &err);
+    snprintf(line, sizeof(line), "%s dec %s len=%zu ok=%d reason=%d offset=%zu n=%zu hash=%016llx", c->name, label, enc_len, ok,
+             (int)err.reason, ok ? (size_t)0 : err.offset, ok ? n : (size_t)0, ok ? (unsigned long long)fnv1a(out, n) : 0ull);
+    note(line);
+}
+
+static void codec_cases(const codec *c, const uint8_t *raw) {
+    static char enc[MAX_ENC], bent[MAX_ENC];
+    static uint8_t back[MAX_ENC];
+    char line[256], label[64];
+    static const size_t big[] = { 255, 256, 257, 1000, 1024, 4099, MAX_RAW };
+
+    for (size_t k = 0; k < 200 + sizeof(big) / sizeof(big[0]); k++) {
+        size_t len = k < 200 ? k + 1 : big[k - 200];
+        if (len % c->raw_q) continue;
+
+        size_t enc_len = 0, n = 0;
+        bool ok = encode(c, raw, len, enc, &enc_len);
+        snprintf(line, sizeof(line), "%s enc len=%zu ok=%d n=%zu hash=%016llx", c->name, len, ok, enc_len,
+                 (unsigned long long)fnv1a((const uint8_t *)enc, ok ? enc_len : 0));
+        note(line);
+        if (!ok) {
+            fail(line);
+            continue;
+        }
+
+        // Round trip
+        if (!BASE_DecodeEx(enc, enc_len, back, &n, c->dec_flags, NULL) || n != len || memcmp(back, raw, len) != 0) {
+            snprintf(line, sizeof(line), "%s round trip len=%zu", c->name, len);
+            fail(line);
+        }
+
+        // Lengths around the block sizes also get bad chars and padding planted in every block
+        if (!(len % 16 == 0 || len % 16 == 1 || len % 16 == 15 || len > 200)) continue;
+        size_t stride = enc_len > 300 ? 13 : 1;
+        for (size_t p = 0; p < enc_len; p += stride) {
+            memcpy(bent, enc, enc_len);
+            bent[p] = c->bad;
+            snprintf(label, sizeof(label), "bad@%zu", p);
+            decode_case(c, label, bent, enc_len);
+
+            // The scalar decoders report the first bad char: the vector loop must hand over to them
+            BASE_Error err = { BASE_ERR_NONE, 0, 0 };
+            if (c->first_bad && (BASE_DecodeEx(bent, enc_len, back, &n, c->dec_flags, &err) || err.reason != BASE_ERR_INVALID_CHAR || err.offset != p)) {
+                snprintf(line, sizeof(line), "%s len=%zu bad char at %zu: reason=%d offset=%zu", c->name, len, p, (int)err.reason, err.offset);
+                fail(line);
+            }
+
+            if (c->padded && p + 2 <= enc_len) {
+                memcpy(bent, enc, enc_len);
+                bent[p] = '=';
+                snprintf(label, sizeof(label), "pad1@%zu", p);
+                decode_case(c, label, bent, enc_len);
+                bent[p + 1] = '=';
+                snprintf(label, sizeof(label), "pad2@%zu", p);
+                decode_case(c, label, bent, enc_len);
+            }
+        }
+    }
+
+    // A padded quantum followed by more data, the padding landing inside a block
+    if (c->padded) {
+        for (size_t head = 1; head < 40; head++) {
+            size_t a = 0, b = 0;
+            encode(c, raw, head, enc, &a);
+            encode(c, raw + head, 100, enc + a, &b);
+            snprintf(label, sizeof(label), "concat@%zu", head);
+            decode_case(c, label, enc, a + b);
+        }
+    }
+}
+
+// WHATWG forgiving-base64 (atob): fixed expectations, no SIMD involved
+static void forgiving_cases(void) {
+    static const struct {
+        const char *in;
+        bool ok;
+        size_t n;
+    } cases_[] = {
+        { "AA==", true, 1 },
+        { "AAA=", true, 2 },
+        { "AA", true, 1 },
+        { " A A = = ", true, 1 },
+        { "====", false, 0 },
+        { "AAAA====", false, 0 },
+        { "A===", false, 0 },
+        { "AAAA=", false, 0 },
+        { "AA=", false, 0 },
+        { "AAA==", false, 0 },
+    };
+    uint8_t out[16];
+    char line[128];
+
+    for (size_t i = 0; i < sizeof(cases_) / sizeof(cases_[0]); i++) {
+        size_t n = 0;
+        bool ok = BASE_DecodeEx(cases_[i].in, strlen(cases_[i].in), out, &n, BASE64_STD_DEC | BASE64_FORGIVING_DEC, NULL);
+        snprintf(line, sizeof(line), "forgiving \"%s\" ok=%d n=%zu", cases_[i].in, ok, ok ? n : (size_t)0);
+        note(line);
+        if (ok != cases_[i].ok || (ok && n != cases_[i].n)) fail(line);
+    }
+
+    // JSON tokens and data: URIs decode through the same forgiving path
+    static const char *bad_json[] = { "\"====\"", "\"AAAA====\"", "\"AAAA\\u003D\\u003D\\u003D\\u003D\"" };
+    for (size_t i = 0; i < sizeof(bad_json) / sizeof(bad_json[0]); i++) {
+        size_t n = 0;
+        bool ok = BASE64_DecodeJson(bad_json[i], strlen(bad_json[i]), out, &n, BASE64_STD_DEC | BASE64_FORGIVING_DEC);
+        snprintf(line, sizeof(line), "forgiving json %s ok=%d", bad_json[i], ok);
+        note(line);
+        if (ok) fail(line);
+    }
+
+    // Bodies are URL-encoded: escapes are resolved before the forgiving decode
+    static const struct {
+        const char *uri;
+        const char *data;
+    } good_uri[] = {
+        { "data:text/plain;base64,SGk=", "Hi" },
+        { "data:text/plain;base64,SGk%3D", "Hi" },
+        { "data:text/plain;base64,SGk%3d", "Hi" },
+        { "data:;base64,%53%47%6B%3D", "Hi" },
+        { "data:;base64,SGVs%0AbG8%2B", "Hello>" },
+    };
+    for (size_t i = 0; i < sizeof(good_uri) / sizeof(good_uri[0]); i++) {
+        BASE64_DataUri view;
+        size_t n = 0;
+        bool ok = BASE64_DecodeDataUri(good_uri[i].uri, strlen(good_uri[i].uri), out, sizeof(out), &view, &n);
+        snprintf(line, sizeof(line), "uri %s ok=%d n=%zu", good_uri[i].uri, ok, ok ? n : (size_t)0);
+        note(line);
+        if (!ok || n != strlen(good_uri[i].data) || memcmp(out, good_uri[i].data, n) != 0) fail(line);
+    }
+
+    static const char *bad_uri[] = { "data:;base64,====", "data:text/plain;base64,AAAA====", "data:;base64,SGk%3",
+                                     "data:;base64,SGk%G0", "data:;base64,SGk%C3%A9", "data:;base64,SGk%3D%3D%3D" };
+    for (size_t i = 0; i < sizeof(bad_uri) / sizeof(bad_uri[0]); i++) {
+        BASE64_DataUri view;
+        size_t n = 0;
+        bool ok = BASE64_DecodeDataUri(bad_uri[i], strlen(bad_uri[i]), out, sizeof(out), &view, &n);
+        snprintf(line, sizeof(line), "forgiving uri %s ok=%d", bad_uri[i], ok);
+        note(line);
+        if (ok) fail(line);
+    }
+}
+
+// Adobe <~ ~> and btoa output must read back through BASE85_DecodeFramed, with
+// the "~>" marker never split by a line break and the output inside BASE_GetEncodeLen
+static void framed_cases(const uint8_t *raw) {
+    static const struct {
+        const char *name;
+        int enc_flags;
+        int dec_flags;
+    } modes[] = {
+        { "adobe",     BASE85_STD_ENC | BASE85_ADOBE_FRAME, BASE85_STD_DEC | BASE85_ADOBE_FRAME },
+        { "adobe_ext", BASE85_EXT_ENC | BASE85_ADOBE_FRAME, BASE85_EXT_DEC | BASE85_ADOBE_FRAME },
+        { "btoa",      BASE85_STD_ENC | BASE85_BTOA,        BASE85_STD_DEC | BASE85_BTOA        },
+        { "btoa_ext",  BASE85_EXT_ENC | BASE85_BTOA,        BASE85_EXT_DEC | BASE85_BTOA        },
+    };
+    static uint8_t src[MAX_RAW], back[MAX_ENC];
+    static char enc[MAX_ENC];
+    char line[256];
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        bool adobe = (modes[m].enc_flags & BASE85_ADOBE_FRAME) != 0;
+
+        for (size_t len = 1; len <= 700; len += (len < 400 ? 1 : 37)) {
+            // Random bytes with runs of zeros and spaces, so 'z'/'y' shift the line breaks
+            memcpy(src, raw, len);
+            for (size_t j = 0; j + 4 <= len; j += 4) {
+                uint32_t r = next_rand() % 8;
+                if (r == 0) memset(src + j, 0, 4);
+                else if (r == 1) memset(src + j, ' ', 4);
+            }
+
+            size_t cap = BASE_GetEncodeLen(len, (uint32_t)modes[m].enc_flags);
+            size_t enc_len = 0, n = 0, consumed = 0;
+            bool ok = BASE85_Encode(src, len, enc, &enc_len, modes[m].enc_flags);
+            snprintf(line, sizeof(line), "%s enc len=%zu ok=%d n=%zu hash=%016llx", modes[m].name, len, ok, enc_len,
+                     (unsigned long long)fnv1a((const uint8_t *)enc, ok ? enc_len : 0));
+            note(line);
+            if (!ok || enc_len + 1 > cap) {
+                snprintf(line, sizeof(line), "%s len=%zu wrote %zu chars, BASE_GetEncodeLen gives %zu", modes[m].name, len, enc_len + 1, cap);
+                fail(line);
+                continue;
+            }
+            if (adobe && (enc_len < 2 || memcmp(enc + enc_len - 2, "~>", 2) != 0)) {
+                snprintf(line, sizeof(line), "%s len=%zu output does not end in \"~>\"", modes[m].name, len);
+                fail(line);
+            }
+
+            // The decoder stops at the end marker, so text after it is left alone
+            memcpy(enc + enc_len, "\n%%EOF", 7);
+            ok = BASE85_DecodeFramed(enc, enc_len + 6, back, &n, &consumed, modes[m].dec_flags);
+            snprintf(line, sizeof(line), "%s dec len=%zu ok=%d n=%zu consumed=%zu", modes[m].name, len, ok, ok ? n : (size_t)0,
+                     ok ? consumed : (size_t)0);
+            note(line);
+            if (!ok || n != len || memcmp(back, src, len) != 0 || consumed > enc_len || strspn(enc + consumed, " \t\r\n") < enc_len - consumed) {
+                snprintf(line, sizeof(line), "%s round trip len=%zu", modes[m].name, len);
+                fail(line);
+            }
+        }
+    }
+
+    // Other writers wrap "~>" like body text
+    static const char split[] = "<~87cURD]i,\"Ebo7~\n>";
+    uint8_t out[16];
+    size_t n = 0, consumed = 0;
+    bool ok = BASE85_DecodeFramed(split, sizeof(split) - 1, out, &n, &consumed, BASE85_STD_DEC | BASE85_ADOBE_FRAME);
+    snprintf(line, sizeof(line), "adobe split end marker ok=%d n=%zu", ok, ok ? n : (size_t)0);
+    note(line);
+    if (!ok || n != 11 || memcmp(out, "Hello World", 11) != 0 || consumed != sizeof(split) - 1) fail(line);
+}
+
+// Range decode must give exactly the bytes of the full decode, reading the
+// partial first and last quanta on their own, and fail past the end
+static void range_cases(const uint8_t *raw) {
+    static const struct {
+        const char *name;
+        int enc_flags;
+        int dec_flags;
+    } modes[] = {
+        { "base16",           BASE16_UPPER,                      BASE16_DECODE                     },
+        { "base32",           BASE32_ENC,                        BASE32_DEC                        },
+        { "base32_nopad",     BASE32_ENC | BASE32_ENC_NOPAD,     BASE32_DEC | BASE32_DEC_NOPAD     },
+        { "base64",           BASE64_STD_ENC,                    BASE64_STD_DEC                    },
+        { "base64_url_nopad", BASE64_URL_ENC | BASE64_NOPAD_ENC, BASE64_URL_DEC | BASE64_NOPAD_DEC },
+    };
+    static const size_t lens[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 31, 32, 33, 47, 48, 49, 64, 65, 100, 1000, 4099 };
+    static char enc[MAX_ENC];
+    static uint8_t out[MAX_RAW + 16];
+    char line[256];
+
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        const codec c = { modes[m].name, modes[m].enc_flags, modes[m].dec_flags, 1, 0, false, false };
+
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+            size_t len = lens[l], enc_len = 0;
+            if (!encode(&c, raw, len, enc, &enc_len)) {
+                fail("range encode");
+                continue;
+            }
+
+            // Random ranges, then ranges ending on the last byte (the padded
+            // quantum) and running one byte past it
+            for (size_t k = 0; k < 40; k++) {
+                size_t off, n;
+                if (k < 24) {
+                    off = next_rand() % len;
+                    n = 1 + next_rand() % (len - off);
+                } else if (k < 32) {
+                    n = 1 + next_rand() % len;
+                    off = len - n;
+                } else {
+                    off = next_rand() % (len + 1);
+                    n = len - off + 1 + next_rand() % 3;
+                }
+                bool want = off + n <= len;
+
+                memset(out, 0xA5, n);
+                bool ok;
+                if (modes[m].dec_flags & BASE16_DECODE) ok = BASE16_DecodeRange(enc, enc_len, off, n, out);
+                else if (modes[m].dec_flags & BASE32_DEC) ok = BASE32_DecodeRange(enc, enc_len, off, n, out, modes[m].dec_flags);
+                else ok = BASE64_DecodeRange(enc, enc_len, off, n, out, modes[m].dec_flags);
+
+                snprintf(line, sizeof(line), "%s range len=%zu off=%zu n=%zu ok=%d hash=%016llx", modes[m].name, len, off, n, ok,
+                         ok ? (unsigned long long)fnv1a(out, n) : 0ull);
+                note(line);
+                if (ok != want || (ok && memcmp(out, raw + off, n) != 0)) fail(line);
+            }
+        }
+    }
+}
+
+// Wraps enc into lines of width chars (0 = ragged, 1..100), each ended by eol;
+// split_pad puts a break between a final "==". Returns the text length.
+static size_t wrap_lines(const char *enc, size_t enc_len, size_t width, const char *eol, bool split_pad, char *text) {
+    size_t eol_len = strlen(eol), t = 0, col = 0;
+    size_t line = width ? width : 1 + next_rand() % 100;
+
+    for (size_t i = 0; i < enc_len; i++) {
+        if (col == line || (split_pad && i == enc_len - 1)) {
+            memcpy(text + t, eol, eol_len);
+            t += eol_len;
+            col = 0;
+            line = width ? width : 1 + next_rand() % 100;
+        }
+        text[t++] = enc[i];
+        col++;
+    }
+    memcpy(text + t, eol, eol_len);
+    return t + eol_len;
+}
+
+// Indexed range decode over wrapped bodies must match the raw bytes: fixed
+// and ragged widths, quanta split by breaks, "\r\n", a split "==", and a
+// body long enough to use several checkpoints
+static void line_index_cases(void) {
+    static const struct {
+        size_t width;
+        const char *eol;
+    } layouts[] = {
+        { 64, "\n" }, { 76, "\n" }, { 76, "\r\n" }, { 30, "\n" }, { 0, "\n" }, { 0, "\r\n" },
+    };
+    static const size_t lens[] = { 1, 2, 3, 1000, 1001, 1002, BASE64_INDEX_STEP * 2 + 1001 };
+    const size_t max_len = BASE64_INDEX_STEP * 2 + 1001;
+    uint8_t *raw = (uint8_t *)malloc(max_len), *out = (uint8_t *)malloc(max_len + 16);
+    char *enc = (char *)malloc(max_len * 2), *text = (char *)malloc(max_len * 4);
+    char line[256];
+
+    if (!raw || !out || !enc || !text) {
+        fail("line index: out of memory");
+        free(raw);
+        free(out);
+        free(enc);
+        free(text);
+        return;
+    }
+    for (size_t i = 0; i < max_len; i++) raw[i] = (uint8_t)next_rand();
+
+    for (size_t l = 0; l < sizeof(layouts) / sizeof(layouts[0]); l++) {
+        for (size_t li = 0; li < sizeof(lens) / sizeof(lens[0]); li++) {
+            size_t len = lens[li], enc_len = 0;
+            if (!BASE64_Encode(raw, len, enc, &enc_len, BASE64_STD_ENC)) {
+                fail("line index encode");
+                continue;
+            }
+            bool split_pad = enc_len >= 2 && enc[enc_len - 2] == '=';
+            size_t text_len = wrap_lines(enc, enc_len, layouts[l].width, layouts[l].eol, split_pad, text);
+
+            size_t max_marks = BASE64_INDEX_MARKS(text_len);
+            BASE64_LineMark *marks = (BASE64_LineMark *)malloc(max_marks * sizeof(*marks));
+            BASE64_LineIndex index;
+            bool ok = marks && BASE64_IndexLines(text, text_len, BASE64_STD_DEC, marks, max_marks, &index);
+            snprintf(line, sizeof(line), "index width=%zu eol=%zu len=%zu ok=%d marks=%zu dec_len=%zu", layouts[l].width,
+                     strlen(layouts[l].eol), len, ok, ok ? index.count : (size_t)0, ok ? index.dec_len : (size_t)0);
+            note(line);
+            if (!ok || index.dec_len != len || (len > BASE64_INDEX_STEP && index.count < 2)) {
+                fail(line);
+                free(marks);
+                continue;
+            }
+
+            // Random ranges, ranges ending on the last byte, ranges past it
+            for (size_t k = 0; k < 40; k++) {
+                size_t off, n;
+                if (k < 24) {
+                    off = next_rand() % len;
+                    n = 1 + next_rand() % (len - off < 5000 ? len - off : 5000);
+                } else if (k < 32) {
+                    n = 1 + next_rand() % (len < 5000 ? len : 5000);
+                    off = len - n;
+                } else {
+                    off = next_rand() % (len + 1);
+                    n = len - off + 1 + next_rand() % 3;
+                }
+                bool want = off + n <= len;
+
+                ok = BASE64_DecodeRangeIndexed(text, text_len, &index, off, n, out);
+                snprintf(line, sizeof(line), "index width=%zu eol=%zu len=%zu range off=%zu n=%zu ok=%d hash=%016llx", layouts[l].width,
+                         strlen(layouts[l].eol), len, off, n, ok, ok ? (unsigned long long)fnv1a(out, n) : 0ull);
+                note(line);
+                if (ok != want || (ok && memcmp(out, raw + off, n) != 0)) fail(line);
+            }
+            free(marks);
+        }
+    }
+
+    free(raw);
+    free(out);
+    free(enc);
+    free(text);
+}
+
+// RFC 1924: the RFC's example address, the extreme values, values just past
+// 2^128 - 1 (must fail), and random values through the single and batch calls
+static void rfc1924_cases(const uint8_t *raw) {
+    static const struct {
+        uint8_t value[RFC1924_BYTES];
+        const char *text;
+    } vectors[] = {
+        { { 0x10, 0x80, 0, 0, 0, 0, 0, 0, 0, 0x08, 0x08, 0, 0x20, 0x0C, 0x41, 0x7A }, "4)+k&C#VzJ4br>0wv%Yp" },
+        { { 0 }, "00000000000000000000" },
+        { { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, "=r54lj&NUUO~Hi%c2ym0" },
+    };
+    static const char *bad[] = { "=r54lj&NUUO~Hi%c2ym1", "=r54lj&NUUO~Hi%c2yn0", "~~~~~~~~~~~~~~~~~~~~", "4)+k&C#VzJ4br>0wv%Y\"" };
+    char text[RFC1924_ENC_LEN(1)], line[128];
+    uint8_t value[RFC1924_BYTES];
+
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        bool ok = BASE85_EncodeRfc1924(vectors[i].value, text) && memcmp(text, vectors[i].text, RFC1924_CHARS) == 0 &&
+                  BASE85_DecodeRfc1924(vectors[i].text, value) && memcmp(value, vectors[i].value, RFC1924_BYTES) == 0;
+        snprintf(line, sizeof(line), "rfc1924 %s ok=%d", vectors[i].text, ok);
+        note(line);
+        if (!ok) fail(line);
+    }
+
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        bool ok = BASE85_DecodeRfc1924(bad[i], value);
+        snprintf(line, sizeof(line), "rfc1924 bad %s ok=%d", bad[i], ok);
+        note(line);
+        if (ok) fail(line);
+    }
+
+    // 64 random values: single calls and one batch must agree and round-trip
+    enum { NVAL = 64 };
+    static char batch_text[RFC1924_ENC_LEN(NVAL)];
+    static uint8_t batch_back[RFC1924_DEC_LEN(NVAL)];
+    bool ok = BASE85_EncodeRfc1924Batch(raw, NVAL, batch_text) && BASE85_DecodeRfc1924Batch(batch_text, NVAL, batch_back) &&
+              memcmp(batch_back, raw, RFC1924_DEC_LEN(NVAL)) == 0;
+    for (size_t i = 0; ok && i < NVAL; i++) {
+        ok = BASE85_EncodeRfc1924(raw + i * RFC1924_BYTES, text) && memcmp(text, batch_text + i * RFC1924_CHARS, RFC1924_CHARS) == 0;
+    }
+    snprintf(line, sizeof(line), "rfc1924 random ok=%d hash=%016llx", ok, (unsigned long long)fnv1a((const uint8_t *)batch_text, NVAL * RFC1924_CHARS));
+    note(line);
+    if (!ok) fail(line);
+}
+
+// Padded Z85 ends like Ascii85: n trailing bytes as n + 1 chars, the output
+// of Python's base64.z85encode; a 1-char group cannot be decoded
+static void z85_pad_cases(void) {
+    static const struct {
+        const char *raw;
+        size_t raw_len;
+        const char *z85;
+    } vectors[] = {
+        { "\x00", 1, "00" },
+        { "abc", 3, "vpAZ" },
+        { "\xff\xff\xff", 3, "%nS9" },
+        { "Hello", 5, "nm=QNzV" },
+        { "\x86\x4f\xd2\x6f\xb5", 5, "HelloWe" },
+        { "HelloWorld", 10, "nm=QNz=Z<$y?9" },
+    };
+    char enc[32], line[128];
+    uint8_t back[32];
+
+    for (size_t i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++) {
+        size_t n = 0, m = 0;
+        bool ok = BASE85_EncodeZ85Pad((const uint8_t *)vectors[i].raw, vectors[i].raw_len, enc, &n) &&
+                  n == strlen(vectors[i].z85) && memcmp(enc, vectors[i].z85, n) == 0 &&
+                  BASE85_DecodeZ85Pad(vectors[i].z85, n, back, &m) && m == vectors[i].raw_len &&
+                  memcmp(back, vectors[i].raw, m) == 0;
+        snprintf(line, sizeof(line), "z85_pad \"%s\" ok=%d", vectors[i].z85, ok);
+        note(line);
+        if (!ok) fail(line);
+    }
+
+    size_t n = 0;
+    BASE_Error err = { BASE_ERR_NONE, 0, 0 };
+    bool ok = BASE_DecodeEx("HelloW", 6, back, &n, BASE85_Z85_DEC | BASE85_Z85_PAD, &err);
+    snprintf(line, sizeof(line), "z85_pad 1-char group ok=%d reason=%d", ok, (int)err.reason);
+    note(line);
+    if (ok || err.reason != BASE_ERR_BAD_LENGTH) fail(line);
+}
+
+// JWT segments are unpadded base64url: '=' anywhere must fail, in the scalar
+// tail of the dot scan and inside its 16-byte blocks
+static void jwt_cases(void) {
+    static const struct {
+        const char *token;
+        bool ok;
+    } fixed[] = {
+        { "e30.e30.YWJj", true },
+        { "e30.e30.", true },
+        { "e30=.e30.YWJj", false },
+        { "e30.e30=.YWJj", false },
+        { "e30.e30.YWI=", false },
+        { "e30.e30.YW=j", false },
+        { "e30.e30.=WJj", false },
+        { "e30.e30.YWJj.e30", false },
+    };
+    static uint8_t arena[BASE64_JWT_DEC_LEN(256)];
+    char token[256], line[256];
+
+    for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++) {
+        BASE64_Jwt parts;
+        size_t n = 0;
+        bool ok = BASE64_DecodeJwt(fixed[i].token, strlen(fixed[i].token), arena, sizeof(arena), &parts, &n);
+        snprintf(line, sizeof(line), "jwt %s ok=%d n=%zu", fixed[i].token, ok, ok ? n : (size_t)0);
+        note(line);
+        if (ok != fixed[i].ok) fail(line);
+    }
+
+    // 40-char segments: '=' planted at every position of each segment
+    static const char seg[] = "eyJhbGciOiJIUzI1NiIsInR5cCI6IkpXVCJ9abcd";
+    const size_t seg_len = sizeof(seg) - 1;
+    const size_t token_len = 3 * seg_len + 2;
+    snprintf(token, sizeof(token), "%s.%s.%s", seg, seg, seg);
+    {
+        BASE64_Jwt parts;
+        size_t n = 0;
+        if (!BASE64_DecodeJwt(token, token_len, arena, sizeof(arena), &parts, &n) || n != 90) fail("jwt 40-char segments");
+    }
+    for (size_t p = 0; p < token_len; p++) {
+        if (token[p] == '.') continue;
+        char keep = token[p];
+        token[p] = '=';
+        BASE64_Jwt parts;
+        size_t n = 0;
+        bool ok = BASE64_DecodeJwt(token, token_len, arena, sizeof(arena), &parts, &n);
+        snprintf(line, sizeof(line), "jwt '=' at %zu ok=%d", p, ok);
+        note(line);
+        if (ok) fail(line);
+        token[p] = keep;
+    }
+}
+
+// Every mode BASE_Detect reports must decode the input: detect, then decode once
+static void detect_cases(void) {
+    static const char *inputs[] = {
+        "AAAA ====", " ====", "A A A A = = = =", "AAAA\n====", // padding after a full quantum
+        "AA\n==", "AAA =", "QUJD\nREVG\n", "AAAA====", "QUJDRA==",
+    };
+    uint8_t out[16];
+    char line[128];
+
+    for (size_t i = 0; i < sizeof(inputs) / sizeof(inputs[0]); i++) {
+        int modes[BASE_DETECT_MAX];
+        size_t len = strlen(inputs[i]);
+        size_t found = BASE_Detect(inputs[i], len, modes, BASE_DETECT_MAX);
+        for (size_t m = 0; m < found; m++) {
+            size_t n = 0;
+            bool ok = BASE_DecodeEx(inputs[i], len, out, &n, modes[m], NULL);
+            snprintf(line, sizeof(line), "detect case %zu mode %#x ok=%d", i, (unsigned)modes[m], ok);
+            note(line);
+            if (!ok) fail(line);
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    if (argc == 3 && strcmp(argv[1], "--write") == 0) {
+        record = fopen(argv[2], "w");
+        if (!record) {
+            perror(argv[2]);
+            return 2;
+        }
+    } else if (argc == 3 && strcmp(argv[1], "--check") == 0) {
+        reference = fopen(argv[2], "r");
+        if (!reference) {
+            perror(argv[2]);
+            return 2;
+        }
+    } else if (argc != 1) {
+        fprintf(stderr, "Usage: %s [--write FILE | --check FILE]\n", argv[0]);
+        return 2;
+    }
+
+    static uint8_t raw[MAX_RAW];
+    for (size_t i = 0; i < MAX_RAW; i++) raw[i] = (uint8_t)next_rand();
+
+    for (size_t i = 0; i < sizeof(CODECS) / sizeof(CODECS[0]); i++) codec_cases(&CODECS[i], raw);
+    forgiving_cases();
+    framed_cases(raw);
+    jwt_cases();
+    z85_pad_cases();
+    range_cases(raw);
+    line_index_cases();
+    rfc1924_cases(raw);
+    detect_cases();
+
+    if (reference) {
+        char extra[256];
+        if (fgets(extra, sizeof(extra), reference)) fail("record has more cases than this build");
+        fclose(reference);
+    }
+    if (record && fclose(record) != 0) fail("cannot write the record");
+
+    printf("%lu cases, %lu failures\n", cases, failures);
+    return failures ? 1 : 0;
+}